@@ -0,0 +1,33 @@
+#include "quantum.h"
+#include "../../lib/rdr_lib/rdr_common.h"
+#include "battery_governor.h"
+
+static uint8_t  scale = 255;
+static uint16_t current_ma;
+
+void battery_governor_frame(uint32_t channel_sum) {
+    current_ma = channel_sum * BATTERY_GOVERNOR_CHANNEL_MA / 255;
+
+    if (Keyboard_Info.Key_Mode == QMK_USB_MODE) {
+        scale = 255;
+        return;
+    }
+
+    // the frame was rendered at the current scale, what it would draw unscaled
+    uint32_t full_ma = (uint32_t)current_ma * 255 / MAX(scale, 1);
+    uint8_t  target  = full_ma > BATTERY_GOVERNOR_BUDGET_MA ? BATTERY_GOVERNOR_BUDGET_MA * 255 / full_ma : 255;
+
+    if (target < scale) {
+        scale = MAX(target, scale - BATTERY_GOVERNOR_STEP);
+    } else if (target > scale) {
+        scale = MIN(target, scale + BATTERY_GOVERNOR_STEP);
+    }
+}
+
+uint8_t battery_governor_scale(void) {
+    return scale;
+}
+
+uint16_t battery_governor_current_ma(void) {
+    return current_ma;
+}
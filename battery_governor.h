@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+// RGB brightness held under a current budget on battery.
+//
+// The table effects add up the channel values they set and report the
+// sum once per frame. The governor turns that into an LED current
+// estimate and moves a brightness scale towards the one that fits
+// BATTERY_GOVERNOR_BUDGET_MA in the wireless modes. Over USB the scale
+// stays at full. Everything is integer math, a frame update is a few
+// multiplies.
+//
+// The budget is fixed. rdr_lib has no documented battery reading for
+// QMK code; the charge it shows on QK_BAT comes from the radio module
+// and its field and units are not known, so the budget does not follow
+// the charge. A lower budget for a smaller battery is a config.h
+// override.
+
+// current of one LED channel at 255
+#ifndef BATTERY_GOVERNOR_CHANNEL_MA
+#    define BATTERY_GOVERNOR_CHANNEL_MA 12
+#endif
+#ifndef BATTERY_GOVERNOR_BUDGET_MA
+#    define BATTERY_GOVERNOR_BUDGET_MA 400
+#endif
+// largest scale change per frame, keeps the fade invisible
+#ifndef BATTERY_GOVERNOR_STEP
+#    define BATTERY_GOVERNOR_STEP 4
+#endif
+
+void     battery_governor_frame(uint32_t channel_sum);
+uint8_t  battery_governor_scale(void);
+uint16_t battery_governor_current_ma(void);
@@ -0,0 +1,101 @@
+#include "quantum.h"
+#include "boot_profile.h"
+#include "housekeeping_sched.h"
+#include "power_state.h"
+
+#define BOOT_PROFILE_MAGIC 0x424F4F54
+
+// not cleared by crt0, survives a reset but not a power cut
+static struct {
+    uint32_t      magic;
+    uint16_t      boots; // resets since power-on
+    boot_record_t current;
+    boot_record_t previous;
+} profile __attribute__((section(".ram0.boot_profile")));
+
+static uint32_t wake_start;
+static bool     wake_armed;
+static bool     rgb_deferred;
+
+static void record_clear(boot_record_t *record) {
+    memset(record, 0, sizeof(*record));
+    for (uint8_t phase = 0; phase < BOOT_PHASES; phase++) {
+        record->phase_us[phase] = BOOT_NOT_REACHED;
+    }
+}
+
+// from board_init, ahead of every other phase and of the system tick
+void boot_profile_init(void) {
+    if (profile.magic == BOOT_PROFILE_MAGIC) {
+        profile.previous = profile.current;
+        profile.boots++;
+    } else {
+        record_clear(&profile.previous);
+        profile.magic = BOOT_PROFILE_MAGIC;
+        profile.boots = 0;
+    }
+    record_clear(&profile.current);
+}
+
+void boot_profile_mark(uint8_t phase) {
+    if (profile.current.phase_us[phase] == BOOT_NOT_REACHED) {
+        profile.current.phase_us[phase] = housekeeping_now_us();
+    }
+}
+
+// matrix idle mode left, the press that ended it is reported next
+void boot_profile_wake(void) {
+    wake_start = housekeeping_now_us();
+    wake_armed = true;
+}
+
+void boot_profile_report(void) {
+    boot_profile_mark(BOOT_FIRST_REPORT);
+    if (!wake_armed) {
+        return;
+    }
+    wake_armed = false;
+
+    // power_task has not seen the press yet, the state is still the one slept in
+    if (power_get_state() >= POWER_IDLE) {
+        uint32_t took = housekeeping_now_us() - wake_start;
+
+        profile.current.wakes++;
+        profile.current.wake_last_us = took;
+        profile.current.wake_max_us  = MAX(profile.current.wake_max_us, took);
+    }
+}
+
+void boot_profile_defer_rgb(void) {
+#if BOOT_RGB_DELAY
+    if (rgb_matrix_is_enabled()) {
+        rgb_deferred = true;
+        return;
+    }
+#endif
+    boot_profile_mark(BOOT_RGB_READY);
+}
+
+void boot_profile_task(void) {
+    boot_profile_mark(BOOT_FIRST_SCAN);
+    if (!rgb_deferred) {
+        return;
+    }
+    if (profile.current.phase_us[BOOT_FIRST_REPORT] == BOOT_NOT_REACHED && timer_read32() < BOOT_RGB_DELAY) {
+        return;
+    }
+    rgb_deferred = false;
+    boot_profile_mark(BOOT_RGB_READY);
+}
+
+bool boot_profile_rgb_deferred(void) {
+    return rgb_deferred;
+}
+
+uint16_t boot_profile_boots(void) {
+    return profile.boots;
+}
+
+const boot_record_t *boot_profile_record(bool previous) {
+    return previous ? &profile.previous : &profile.current;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Boot phase timestamps and the fast boot path.
+//
+// Each phase is stamped once, in us since chSysInit: the clock setup in
+// __early_init and board_init run before the tick starts and are not
+// timed. Wakes from the power idle and deep states are timed from the
+// scan that leaves matrix idle mode to the report of the first press.
+// The profile sits in the .ram0 noinit section, so a reset keeps the
+// last boot readable as the previous one; a power-on starts both empty.
+// Both are read with the diag raw HID command, util/qk61_hid.py boot.
+//
+// Fast boot: for the first main loop passes the RGB effect is only
+// rendered every BOOT_RGB_INTERVAL ms (rgb_governor.c), so the first
+// scans and reports do not wait behind effect rendering. RGB stays on
+// and nothing in its config is touched, the indicators keep showing and
+// a lighting key pressed meanwhile takes effect at once. Full rate comes
+// back at the first report or after BOOT_RGB_DELAY ms, whichever is
+// first; 0 runs at full rate from the start.
+
+enum boot_phase {
+    BOOT_EEPROM_LOADED, // EEPROM image rebuilt from the flash log, EEPROM_LOG_ENABLE only
+    BOOT_PRE_INIT,      // keyboard_pre_init, matrix pins set up
+    BOOT_POST_INIT,     // keymap, eeconfig and RGB matrix initialized
+    BOOT_VENDOR_INIT,   // vendor post init, radio bring up
+    BOOT_INIT_DONE,     // keyboard_post_init_user returned
+    BOOT_FIRST_SCAN,    // first main loop pass
+    BOOT_USB_READY,     // USB configured by the host
+    BOOT_FIRST_REPORT,  // first key press reported
+    BOOT_RGB_READY,     // lighting running
+    BOOT_PHASES,
+};
+
+#define BOOT_NOT_REACHED UINT32_MAX
+
+typedef struct {
+    uint32_t phase_us[BOOT_PHASES];
+    uint16_t wakes;
+    uint32_t wake_last_us;
+    uint32_t wake_max_us;
+} boot_record_t;
+
+#ifndef BOOT_RGB_DELAY
+#    define BOOT_RGB_DELAY 500
+#endif
+// frame interval until then
+#ifndef BOOT_RGB_INTERVAL
+#    define BOOT_RGB_INTERVAL 100
+#endif
+
+void boot_profile_init(void);
+void boot_profile_mark(uint8_t phase);
+void boot_profile_wake(void);
+void boot_profile_report(void);
+void boot_profile_defer_rgb(void);
+void boot_profile_task(void);
+bool boot_profile_rgb_deferred(void);
+
+uint16_t             boot_profile_boots(void);
+const boot_record_t *boot_profile_record(bool previous);
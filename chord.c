@@ -0,0 +1,283 @@
+#include "quantum.h"
+#include "chord.h"
+
+#define CHORD_MASK_WORDS ((CHORD_POSITIONS + 31) / 32)
+#define CHORD_SET_WORDS (256 / 32)
+
+// chords by key: index_chords[index_start[p]..index_start[p + 1]) contain position p + 1
+static uint32_t member_keys[CHORD_MASK_WORDS];
+static uint16_t index_start[CHORD_POSITIONS + 1];
+static uint8_t  index_chords[CHORD_INDEX_SIZE];
+
+// presses held back while a chord is possible
+static keyevent_t pending[CHORD_MAX_KEYS];
+static uint8_t    pending_count;
+static uint32_t   candidates[CHORD_SET_WORDS]; // chords containing every pending key
+static int16_t    complete = -1;               // candidate made of exactly the pending keys
+static uint8_t    supersets;                   // candidates still waiting for more keys
+static uint16_t   deadline;                    // first superset or complete term, ms from the first press
+
+static struct {
+    uint8_t chord;
+    uint8_t down; // bit per key slot
+    bool    registered;
+} held[CHORD_HELD_MAX];
+
+static bool replaying;
+
+static bool bit_test(const uint32_t *set, uint16_t bit) {
+    return set[bit / 32] & (1UL << (bit % 32));
+}
+
+static void bit_set(uint32_t *set, uint16_t bit) {
+    set[bit / 32] |= 1UL << (bit % 32);
+}
+
+static uint8_t chord_key(uint8_t id, uint8_t slot) {
+    return pgm_read_byte(&chords[id].keys[slot]);
+}
+
+static uint8_t chord_size(uint8_t id) {
+    uint8_t size = 0;
+
+    for (uint8_t slot = 0; slot < CHORD_MAX_KEYS; slot++) {
+        size += chord_key(id, slot) != 0;
+    }
+    return size;
+}
+
+static uint16_t chord_term(uint8_t id) {
+    uint16_t term = pgm_read_word(&chords[id].term);
+
+    return term ? term : CHORD_TERM;
+}
+
+static bool chord_key_valid(uint8_t key) {
+    return key && key <= CHORD_POSITIONS;
+}
+
+void chord_init(void) {
+    uint16_t total = 0;
+    uint8_t  count = 0;
+
+    memset(member_keys, 0, sizeof(member_keys));
+    memset(index_start, 0, sizeof(index_start));
+
+    // count memberships per key, chords past CHORD_INDEX_SIZE are left out
+    for (; count < chords_count; count++) {
+        uint8_t size = chord_size(count);
+
+        if (total + size > CHORD_INDEX_SIZE) {
+            break;
+        }
+        for (uint8_t slot = 0; slot < CHORD_MAX_KEYS; slot++) {
+            uint8_t key = chord_key(count, slot);
+
+            if (chord_key_valid(key)) {
+                index_start[key - 1]++;
+                bit_set(member_keys, key - 1);
+                total++;
+            }
+        }
+    }
+
+    // counts to end offsets, then fill backwards so each becomes a start
+    for (uint8_t p = 1; p <= CHORD_POSITIONS; p++) {
+        index_start[p] += index_start[p - 1];
+    }
+    for (uint8_t id = count; id-- > 0;) {
+        for (uint8_t slot = CHORD_MAX_KEYS; slot-- > 0;) {
+            uint8_t key = chord_key(id, slot);
+
+            if (chord_key_valid(key)) {
+                index_chords[--index_start[key - 1]] = id;
+            }
+        }
+    }
+}
+
+static uint8_t key_position(keypos_t key) {
+    return CHORD_KEY(key.row, key.col);
+}
+
+static bool pending_has(uint8_t key) {
+    for (uint8_t i = 0; i < pending_count; i++) {
+        if (key_position(pending[i].key) == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Narrows the candidates to the chords of key, false if none is left
+static bool chord_add(uint8_t key, keyevent_t event) {
+    uint32_t next[CHORD_SET_WORDS] = {0};
+    uint8_t  size    = pending_count + 1;
+    uint16_t elapsed = pending_count ? timer_elapsed(pending[0].time) : 0;
+    int16_t  found   = -1;
+    uint8_t  more    = 0;
+    uint16_t first   = UINT16_MAX;
+
+    for (uint16_t i = index_start[key - 1]; i < index_start[key]; i++) {
+        uint8_t  id   = index_chords[i];
+        uint16_t term = chord_term(id);
+
+        if ((pending_count && !bit_test(candidates, id)) || elapsed >= term) {
+            continue;
+        }
+        bit_set(next, id);
+        if (chord_size(id) == size) {
+            if (found < 0) {
+                found = id;
+            }
+        } else {
+            more++;
+            first = MIN(first, term);
+        }
+    }
+    if (found < 0 && !more) {
+        return false;
+    }
+
+    memcpy(candidates, next, sizeof(candidates));
+    complete                 = found;
+    supersets                = more;
+    deadline                 = found >= 0 ? MIN(first, chord_term(found)) : first;
+    pending[pending_count++] = event;
+    return true;
+}
+
+static bool chord_hold(uint8_t id) {
+    for (uint8_t i = 0; i < CHORD_HELD_MAX; i++) {
+        if (!held[i].down) {
+            held[i].chord      = id;
+            held[i].registered = true;
+            for (uint8_t slot = 0; slot < CHORD_MAX_KEYS; slot++) {
+                if (chord_key(id, slot)) {
+                    held[i].down |= 1 << slot;
+                }
+            }
+            register_code16(pgm_read_word(&chords[id].keycode));
+            return true;
+        }
+    }
+    return false;
+}
+
+// Sends the complete chord, or replays the pending presses as plain keys
+static void chord_resolve(void) {
+    keyevent_t events[CHORD_MAX_KEYS];
+    uint8_t    count = pending_count;
+
+    memcpy(events, pending, sizeof(events));
+    pending_count = 0;
+    supersets     = 0;
+
+    if (complete >= 0 && chord_hold(complete)) {
+        complete = -1;
+        return;
+    }
+    complete = -1;
+
+    replaying = true;
+    for (uint8_t i = 0; i < count; i++) {
+        action_exec(events[i]);
+    }
+    replaying = false;
+}
+
+// The first key up releases the chord, the others are swallowed
+static bool chord_release(uint8_t key) {
+    for (uint8_t i = 0; i < CHORD_HELD_MAX; i++) {
+        if (!held[i].down) {
+            continue;
+        }
+        for (uint8_t slot = 0; slot < CHORD_MAX_KEYS; slot++) {
+            if (chord_key(held[i].chord, slot) == key && (held[i].down & (1 << slot))) {
+                held[i].down &= ~(1 << slot);
+                if (held[i].registered) {
+                    unregister_code16(pgm_read_word(&chords[held[i].chord].keycode));
+                    held[i].registered = false;
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool process_chord(keyrecord_t *record) {
+    if (replaying) {
+        return true;
+    }
+
+    uint8_t key = key_position(record->event.key);
+
+    if (!record->event.pressed) {
+        if (pending_has(key)) {
+            chord_resolve();
+        }
+        return !chord_release(key);
+    }
+    if (!chord_key_valid(key) || !bit_test(member_keys, key - 1)) {
+        // a key outside every candidate ends the wait
+        if (pending_count) {
+            chord_resolve();
+        }
+        return true;
+    }
+    if (!chord_add(key, record->event)) {
+        if (!pending_count) {
+            return true;
+        }
+        chord_resolve();
+        if (!chord_add(key, record->event)) {
+            return true;
+        }
+    }
+    if (!supersets || pending_count == CHORD_MAX_KEYS) {
+        chord_resolve();
+    }
+    return false;
+}
+
+void chord_task(void) {
+    if (!pending_count) {
+        return;
+    }
+
+    uint16_t elapsed = timer_elapsed(pending[0].time);
+    if (elapsed < deadline) {
+        return;
+    }
+    // the complete chord is sent by its own term, longer ones are given up
+    if (complete >= 0 && elapsed >= chord_term(complete)) {
+        chord_resolve();
+        return;
+    }
+
+    // drop the supersets past their term
+    supersets = 0;
+    deadline  = UINT16_MAX;
+    for (uint8_t word = 0; word < CHORD_SET_WORDS; word++) {
+        for (uint32_t bits = candidates[word]; bits; bits &= bits - 1) {
+            uint8_t  id   = word * 32 + __builtin_ctz(bits);
+            uint16_t term = chord_term(id);
+
+            if (id == complete) {
+                continue;
+            }
+            if (elapsed >= term) {
+                candidates[word] &= ~(1UL << (id % 32));
+            } else {
+                supersets++;
+                deadline = MIN(deadline, term);
+            }
+        }
+    }
+    if (!supersets) {
+        chord_resolve();
+    } else if (complete >= 0) {
+        deadline = MIN(deadline, chord_term(complete));
+    }
+}
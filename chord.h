@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "quantum.h"
+
+// Chords: keys pressed together send another keycode.
+//
+// Unlike QMK combos, nothing is scanned per event. chord_init() builds
+// a per-key index, so a press looks at the chords containing that key
+// only, and a key in no chord is passed on after one bit test, with no
+// buffering. Member keys are held back while a chord is still possible:
+// each chord has its own term from the first press, and a press of any
+// key outside the remaining candidates ends the wait at once; keys that
+// already make a chord send it by that chord's term, however long a
+// chord they could still grow into waits. Held keys that did not form a
+// chord are replayed through action_exec() in order.
+//
+// Each keymap declares its chords by matrix position:
+//
+//     const chord_t PROGMEM chords[] = {
+//         {KC_ESC, 0, {CHORD_KEY(3, 7), CHORD_KEY(3, 8)}},
+//     };
+//     const uint8_t chords_count = ARRAY_SIZE(chords);
+//
+// Built with CHORD_ENABLE = yes in the keymap rules.mk. The chord keycode
+// is registered with register_code16(), so basic keycodes with mods.
+
+#ifndef CHORD_TERM
+#    define CHORD_TERM 25
+#endif
+#ifndef CHORD_MAX_KEYS
+#    define CHORD_MAX_KEYS 4
+#endif
+// chord memberships over all keys, one byte each
+#ifndef CHORD_INDEX_SIZE
+#    define CHORD_INDEX_SIZE 512
+#endif
+// chords held down at the same time
+#ifndef CHORD_HELD_MAX
+#    define CHORD_HELD_MAX 4
+#endif
+
+#define CHORD_POSITIONS (MATRIX_ROWS * MATRIX_COLS)
+// 0 marks an unused key slot
+#define CHORD_KEY(row, col) ((row) * MATRIX_COLS + (col) + 1)
+
+_Static_assert(CHORD_POSITIONS < 0xFF, "matrix positions must fit a byte");
+
+typedef struct {
+    uint16_t keycode;
+    uint16_t term; // ms from the first press, 0 for CHORD_TERM
+    uint8_t  keys[CHORD_MAX_KEYS]; // CHORD_KEY positions
+} chord_t;
+
+extern const chord_t chords[];
+extern const uint8_t chords_count;
+
+void chord_init(void);
+bool process_chord(keyrecord_t *record);
+void chord_task(void);
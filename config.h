@@ -49,12 +49,12 @@
  */
 
 #define MATRIX_UNSELECT_DRIVE_HIGH
-#define CORTEX_ENABLE_WFI_IDLE          FALSE
+#define CORTEX_ENABLE_WFI_IDLE          TRUE    // power_state.c sleeps the main loop, the idle thread waits in WFI
 
 /* Ensure we jump to bootloader if the RESET keycode was pressed */
 #define EARLY_INIT_PERFORM_BOOTLOADER_JUMP TRUE
 
-#define DEBOUNCE 5
+#define DEBOUNCE 5              // shortest per-key window of debounce.c, chattering keys widen up to DEBOUNCE_MAX
 
 #ifndef NOP_FUDGE
 #define NOP_FUDGE 0.4
@@ -63,15 +63,20 @@
 #define RGB_MATRIX_LED_COUNT 64
 #define RGB_MATRIX_KEYPRESSES
 #define RGB_MATRIX_KEYRELEASES
-#define RGB_MATRIX_FRAMEBUFFER_EFFECTS
 #define RGB_DISABLE_AFTER_TIMEOUT 0
-#define RGB_MATRIX_LED_FLUSH_LIMIT 16
+#define RGB_MATRIX_LED_FLUSH_LIMIT 16   // shortest frame interval, rgb_governor.c stretches it while the frame cannot change
 #define RGB_MATRIX_MAXIMUM_BRIGHTNESS 200
+#define RGB_MATRIX_DEFAULT_MODE RGB_MATRIX_CUSTOM_TABLE_CYCLE_LEFT_RIGHT   // rgb_matrix_kb.inc, was the stock cycle_left_right
 #define RGB_MATRIX_SLEEP
 
 // lines from config.h at /keymaps folder
+#ifdef EEPROM_LOG_ENABLE
+#define DYNAMIC_KEYMAP_EEPROM_MAX_ADDR  2039
+#define EEPROM_SIZE 2040               // 8 layers of 6x16 plus macros; eeprom_log.c packs the snapshot and caps this below 2046
+#else
 #define DYNAMIC_KEYMAP_EEPROM_MAX_ADDR  1151
 #define EEPROM_SIZE 1152
+#endif
 
 #define FEE_PAGE_SIZE (0x200)
 #define FEE_PAGE_COUNT (8)
@@ -83,8 +88,11 @@
 
 #define EECONFIG_KB_DATA_SIZE 1
 
+#define VIA_EEPROM_CUSTOM_CONFIG_SIZE 12   // user_config_t, the EECONFIG datablocks belong to rdr_lib
+
 #define TRANSIENT_EEPROM_SIZE 4096
 
 // custom lines
 #define TAPPING_TERM 150	         // custom delay for Tap Dance (default 200 ms)
+#define TAPPING_TERM_PER_KEY         // tap_resolve.c finishes single-tap dances on release
 
@@ -0,0 +1,164 @@
+#include "quantum.h"
+#include "debounce.h"
+#include "debounce_stats.h"
+#include "qk61_trace.h"
+
+// Asymmetric per-key debounce with a window that adapts to chatter.
+//
+// Presses are eager: they are sent at once and the key then ignores the
+// matrix for its window. Releases are deferred until the key has read
+// released for its window. A press that comes within
+// DEBOUNCE_CHATTER_TIME of the key's last release is counted as chatter
+// and widens that key's window by DEBOUNCE_STEP, up to DEBOUNCE_MAX; the
+// extra part of the window also blocks presses right after a release.
+// Keys that stay clean for a DEBOUNCE_DECAY_TIME period narrow back by
+// one step, so healthy keys sit at DEBOUNCE.
+//
+// The matrix is handled a row word at a time: a row whose raw and cooked
+// words match and that has no key counting down costs one compare.
+
+#ifndef DEBOUNCE_MAX
+#    define DEBOUNCE_MAX 25
+#endif
+#ifndef DEBOUNCE_STEP
+#    define DEBOUNCE_STEP 5
+#endif
+#ifndef DEBOUNCE_CHATTER_TIME
+#    define DEBOUNCE_CHATTER_TIME 15
+#endif
+#ifndef DEBOUNCE_DECAY_TIME
+#    define DEBOUNCE_DECAY_TIME 600000
+#endif
+
+_Static_assert(DEBOUNCE_MAX <= UINT8_MAX, "debounce windows are stored in one byte");
+
+static uint8_t      countdown[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t      window[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t      chatter_count[MATRIX_ROWS][MATRIX_COLS];
+static uint32_t     last_release[MATRIX_ROWS][MATRIX_COLS]; // 32 bits, a 16-bit ms wraps every 65 s
+static matrix_row_t pending[MATRIX_ROWS];   // counting down
+static matrix_row_t deferring[MATRIX_ROWS]; // counting down to a release
+static matrix_row_t chattered[MATRIX_ROWS]; // chatter seen this decay period
+
+static uint32_t last_time;
+static uint32_t decay_timer;
+
+void debounce_init(uint8_t num_rows) {
+    memset(countdown, 0, sizeof(countdown));
+    memset(window, DEBOUNCE, sizeof(window));
+    memset(chatter_count, 0, sizeof(chatter_count));
+    memset(pending, 0, sizeof(pending));
+    memset(deferring, 0, sizeof(deferring));
+    memset(chattered, 0, sizeof(chattered));
+    last_time = timer_read32();
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            last_release[row][col] = last_time - DEBOUNCE_CHATTER_TIME;
+        }
+    }
+    decay_timer = timer_read32();
+}
+
+void debounce_free(void) {}
+
+static void debounce_decay(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (!(chattered[row] & (MATRIX_ROW_SHIFTER << col)) && window[row][col] > DEBOUNCE) {
+                window[row][col] = MAX(window[row][col] - DEBOUNCE_STEP, DEBOUNCE);
+            }
+        }
+        chattered[row] = 0;
+    }
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint32_t now            = timer_read32();
+    uint8_t  elapsed        = MIN(TIMER_DIFF_32(now, last_time), UINT8_MAX);
+    bool     cooked_changed = false;
+
+    last_time = now;
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t keys = (raw[row] ^ cooked[row]) | pending[row];
+
+        while (keys) {
+            uint8_t      col = __builtin_ctz(keys);
+            matrix_row_t bit = MATRIX_ROW_SHIFTER << col;
+
+            keys &= ~bit;
+
+            if (pending[row] & bit) {
+                if (deferring[row] & bit) {
+                    if (raw[row] & bit) {
+                        // bounced back before the release was due
+                        pending[row] &= ~bit;
+                        deferring[row] &= ~bit;
+                        continue;
+                    }
+                    if (countdown[row][col] > elapsed) {
+                        countdown[row][col] -= elapsed;
+                        continue;
+                    }
+                    pending[row] &= ~bit;
+                    deferring[row] &= ~bit;
+                    cooked[row] &= ~bit;
+                    cooked_changed          = true;
+                    TRACE(TRACE_DEBOUNCE_COMMIT, row);
+                    last_release[row][col] = now;
+                    if (window[row][col] > DEBOUNCE) {
+                        countdown[row][col] = window[row][col] - DEBOUNCE;
+                        pending[row] |= bit;
+                    }
+                    continue;
+                }
+                if (countdown[row][col] > elapsed) {
+                    countdown[row][col] -= elapsed;
+                    continue;
+                }
+                pending[row] &= ~bit;
+            }
+
+            if (!((raw[row] ^ cooked[row]) & bit)) {
+                continue;
+            }
+
+            countdown[row][col] = window[row][col];
+            pending[row] |= bit;
+
+            if (raw[row] & bit) {
+                cooked[row] |= bit;
+                cooked_changed = true;
+                TRACE(TRACE_DEBOUNCE_COMMIT, row);
+                if (TIMER_DIFF_32(now, last_release[row][col]) < DEBOUNCE_CHATTER_TIME) {
+                    if (chatter_count[row][col] < UINT8_MAX) {
+                        chatter_count[row][col]++;
+                    }
+                    window[row][col] = MIN(window[row][col] + DEBOUNCE_STEP, DEBOUNCE_MAX);
+                    chattered[row] |= bit;
+                }
+            } else {
+                deferring[row] |= bit;
+            }
+        }
+    }
+
+    if (timer_elapsed32(decay_timer) > DEBOUNCE_DECAY_TIME) {
+        decay_timer = timer_read32();
+        debounce_decay();
+    }
+
+    return cooked_changed;
+}
+
+uint8_t debounce_chatter_count(uint8_t row, uint8_t col) {
+    return chatter_count[row][col];
+}
+
+uint8_t debounce_window(uint8_t row, uint8_t col) {
+    return window[row][col];
+}
+
+void debounce_stats_clear(void) {
+    memset(chatter_count, 0, sizeof(chatter_count));
+}
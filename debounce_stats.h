@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+// Per-key counters of debounce.c, read over raw HID by qk61_via.c
+
+uint8_t debounce_chatter_count(uint8_t row, uint8_t col);
+uint8_t debounce_window(uint8_t row, uint8_t col);
+void    debounce_stats_clear(void);
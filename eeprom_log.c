@@ -0,0 +1,517 @@
+#include "quantum.h"
+#include "eeprom_driver.h"
+#include "eeprom_log.h"
+#include "matrix_idle.h"
+#include "boot_profile.h"
+
+// pages are erased and programmed through the ChibiOS EFL driver; a port
+// without an EFL low level driver fails to build here rather than at run time
+#if !HAL_USE_EFL
+#    error "eeprom_log.c needs HAL_USE_EFL in halconf.h"
+#endif
+
+#ifndef FEE_MCU_FLASH_BASE
+#    define FEE_MCU_FLASH_BASE 0x00000000
+#endif
+
+#define EEPROM_LOG_MAGIC 0x4C48 // 0x4C47 tagged 0x0001 for KC_TRNS, 0x4C46 had a hashed record check, 0x4C45 was the unpacked snapshot format
+#define EEPROM_LOG_SNAPSHOT 0x01
+#define EEPROM_LOG_RECORDS 0x02
+
+#define EEPROM_LOG_WORDS (EEPROM_SIZE / 2)
+#define EEPROM_LOG_TAG_BYTES ((EEPROM_LOG_WORDS + 3) / 4)
+#define EEPROM_LOG_PAYLOAD (FEE_PAGE_SIZE - sizeof(fee_page_header_t))
+// the live snapshot, the next one and at least one log page share the ring
+#define EEPROM_LOG_SNAPSHOT_MAX_PAGES ((FEE_PAGE_COUNT - 1) / 2)
+#define EEPROM_LOG_PAGE_RECORDS (EEPROM_LOG_PAYLOAD / sizeof(fee_record_t))
+// literal words a snapshot of EEPROM_LOG_SNAPSHOT_MAX_PAGES can hold
+#define EEPROM_LOG_LITERAL_MAX ((EEPROM_LOG_SNAPSHOT_MAX_PAGES * EEPROM_LOG_PAYLOAD - EEPROM_LOG_TAG_BYTES) / 2)
+
+// Snapshots are stored sparse: a 2-bit tag per word, then the words
+// tagged literal in order. Empty keymap slots, KC_NO/KC_TRNS and unused
+// EEPROM cost two bits instead of two bytes. The dynamic keymap starts at
+// an even address and stores keycodes high byte first, so KC_TRNS is the
+// bytes 00 01, 0x0100 as image_word reads them.
+enum {
+    TAG_ZERO,   // 0x0000, KC_NO
+    TAG_ONE,    // 0x0100, KC_TRNS
+    TAG_ERASED, // 0xFFFF
+    TAG_LITERAL,
+};
+
+typedef struct {
+    uint16_t magic;
+    uint8_t  type;
+    uint8_t  slot; // index within a snapshot
+    uint16_t seq;
+    uint16_t erase_count;
+    uint8_t  slots; // pages of the snapshot
+    uint8_t  reserved[3];
+} fee_page_header_t;
+
+// word index in the low 10 bits, a check of word and value in the top 6
+typedef struct {
+    uint16_t word;
+    uint16_t value;
+} fee_record_t;
+
+_Static_assert(EEPROM_SIZE % 2 == 0, "EEPROM_SIZE must be a whole number of words");
+_Static_assert(EEPROM_LOG_WORDS <= 0x3FF, "record word index is 10 bits, 0x3FF marks a torn record");
+_Static_assert(FEE_PAGE_SIZE * FEE_PAGE_COUNT <= FEE_MCU_FLASH_SIZE, "FEE pages do not fit the reserved flash");
+_Static_assert(EEPROM_LOG_SNAPSHOT_MAX_PAGES * EEPROM_LOG_PAYLOAD >= EEPROM_LOG_TAG_BYTES, "FEE pages too small for the snapshot tags");
+_Static_assert(sizeof(fee_page_header_t) % EEPROM_LOG_PROGRAM_UNIT == 0, "page header must be whole program units");
+_Static_assert(sizeof(fee_record_t) % EEPROM_LOG_PROGRAM_UNIT == 0, "records must be whole program units");
+_Static_assert(EEPROM_LOG_PAYLOAD % EEPROM_LOG_PROGRAM_UNIT == 0, "page payload must be whole program units");
+_Static_assert(FEE_PAGE_BASE_ADDRESS % FEE_PAGE_SIZE == 0, "FEE pages must start on a sector");
+
+static uint8_t  image[EEPROM_SIZE] __attribute__((aligned(4)));
+static uint32_t dirty[(EEPROM_LOG_WORDS + 31) / 32];
+static uint16_t dirty_count;
+static uint16_t literal_words; // words of image a snapshot stores in full
+static bool     need_snapshot;
+static uint16_t erase_counts[FEE_PAGE_COUNT];
+
+static uint8_t  next_page;   // next ring page to erase
+static uint16_t next_seq;
+static uint8_t  snapshot_pages; // pages of the live snapshot
+static int8_t   log_page = -1;  // log page being filled
+static uint16_t log_fill;       // records used in log_page
+static uint8_t  log_pages;      // log pages since the snapshot
+
+static uint32_t           write_timer;
+static bool               held; // eeprom_log_task leaves the image alone
+static eeprom_log_stats_t stats;
+
+static const fee_page_header_t *page_header(uint8_t page) {
+    return (const fee_page_header_t *)(uintptr_t)(FEE_MCU_FLASH_BASE + FEE_PAGE_BASE_ADDRESS + page * FEE_PAGE_SIZE);
+}
+
+static const uint8_t *page_payload(uint8_t page) {
+    return (const uint8_t *)page_header(page) + sizeof(fee_page_header_t);
+}
+
+static bool page_valid(uint8_t page, uint8_t type) {
+    const fee_page_header_t *header = page_header(page);
+
+    return header->magic == EEPROM_LOG_MAGIC && header->type == type;
+}
+
+// The zero bits of word and value. A torn program leaves bits at 1 that
+// should be 0: the count read from the data can only drop and the stored
+// count can only rise, so every torn record fails, not one in 64 as with
+// a hash of the same width.
+static uint16_t record_check(uint16_t word, uint16_t value) {
+    return (26 - __builtin_popcount(word & 0x3FF) - __builtin_popcount(value)) << 10;
+}
+
+static void flash_erase(uint8_t page) {
+    flashStartEraseSector(&EFLD1, EEPROM_LOG_SECTOR(page));
+    flashWaitErase((BaseFlash *)&EFLD1);
+}
+
+static void flash_program(uint8_t page, uint16_t offset, const void *data, size_t size) {
+    flashProgram(&EFLD1, FEE_PAGE_BASE_ADDRESS + page * FEE_PAGE_SIZE + offset, size, data);
+}
+
+// header last, a page cut off before this reads as erased
+static void page_seal(uint8_t page, uint8_t type, uint8_t slot, uint8_t slots) {
+    fee_page_header_t header = {
+        .magic       = EEPROM_LOG_MAGIC,
+        .type        = type,
+        .slot        = slot,
+        .seq         = next_seq++,
+        .erase_count = erase_counts[page],
+        .slots       = slots,
+    };
+
+    flash_program(page, 0, &header, sizeof(header));
+}
+
+static uint8_t page_take(void) {
+    uint8_t page = next_page;
+
+    flash_erase(page);
+    erase_counts[page]++;
+    next_page = (next_page + 1) % FEE_PAGE_COUNT;
+    return page;
+}
+
+static uint16_t image_word(uint16_t word) {
+    return image[word * 2] | (image[word * 2 + 1] << 8);
+}
+
+static uint8_t word_tag(uint16_t value) {
+    switch (value) {
+        case 0x0000:
+            return TAG_ZERO;
+        case 0x0100:
+            return TAG_ONE;
+        case 0xFFFF:
+            return TAG_ERASED;
+        default:
+            return TAG_LITERAL;
+    }
+}
+
+// Snapshot bytes are buffered and programmed page by page
+static struct {
+    uint8_t  page;
+    uint8_t  slot;
+    uint8_t  slots;
+    uint16_t fill; // payload bytes programmed to page
+    uint8_t  count;
+    uint8_t  buffer[16];
+} writer;
+
+_Static_assert(sizeof(writer.buffer) % EEPROM_LOG_PROGRAM_UNIT == 0, "snapshot chunks must be whole program units");
+
+// only the last chunk of a snapshot can be short, 0xFF pads it to a whole unit
+static void writer_program(void) {
+    while (writer.count % EEPROM_LOG_PROGRAM_UNIT) {
+        writer.buffer[writer.count++] = 0xFF;
+    }
+    flash_program(writer.page, sizeof(fee_page_header_t) + writer.fill, writer.buffer, writer.count);
+    writer.fill += writer.count;
+    writer.count = 0;
+}
+
+static void writer_put(uint8_t byte) {
+    if (writer.fill + writer.count == EEPROM_LOG_PAYLOAD) {
+        writer_program();
+        page_seal(writer.page, EEPROM_LOG_SNAPSHOT, writer.slot++, writer.slots);
+        writer.page = page_take();
+        writer.fill = 0;
+    }
+    writer.buffer[writer.count++] = byte;
+    if (writer.count == sizeof(writer.buffer)) {
+        writer_program();
+    }
+}
+
+static bool write_snapshot(void) {
+    if (!eeprom_log_packs()) {
+        return false;
+    }
+
+    uint16_t size  = EEPROM_LOG_TAG_BYTES + literal_words * 2;
+    uint8_t  slots = (size + EEPROM_LOG_PAYLOAD - 1) / EEPROM_LOG_PAYLOAD;
+
+    writer.page  = page_take();
+    writer.slot  = 0;
+    writer.slots = slots;
+    writer.fill  = 0;
+    writer.count = 0;
+
+    for (uint16_t word = 0; word < EEPROM_LOG_WORDS; word += 4) {
+        uint8_t tags = 0;
+
+        for (uint8_t i = 0; i < 4 && word + i < EEPROM_LOG_WORDS; i++) {
+            tags |= word_tag(image_word(word + i)) << (i * 2);
+        }
+        writer_put(tags);
+    }
+    for (uint16_t word = 0; word < EEPROM_LOG_WORDS; word++) {
+        if (word_tag(image_word(word)) == TAG_LITERAL) {
+            writer_put(image[word * 2]);
+            writer_put(image[word * 2 + 1]);
+        }
+    }
+    writer_program();
+    page_seal(writer.page, EEPROM_LOG_SNAPSHOT, writer.slot, writer.slots);
+
+    memset(dirty, 0, sizeof(dirty));
+    dirty_count    = 0;
+    need_snapshot  = false;
+    snapshot_pages = slots;
+    log_page       = -1;
+    log_pages      = 0;
+    stats.snapshots++;
+    return true;
+}
+
+static void append_record(uint16_t word) {
+    if (log_page < 0 || log_fill >= EEPROM_LOG_PAGE_RECORDS) {
+        log_page = page_take();
+        page_seal(log_page, EEPROM_LOG_RECORDS, 0, 0);
+        log_fill = 0;
+        log_pages++;
+    }
+
+    uint16_t     value  = image_word(word);
+    fee_record_t record = {.word = word | record_check(word, value), .value = value};
+
+    // one program unit, a record torn part way fails its check
+    flash_program(log_page, sizeof(fee_page_header_t) + log_fill * sizeof(record), &record, sizeof(record));
+    log_fill++;
+}
+
+static uint16_t log_space(void) {
+    // the next snapshot may need EEPROM_LOG_SNAPSHOT_MAX_PAGES free pages
+    uint16_t space = (FEE_PAGE_COUNT - snapshot_pages - EEPROM_LOG_SNAPSHOT_MAX_PAGES - log_pages) * EEPROM_LOG_PAGE_RECORDS;
+
+    if (log_page >= 0) {
+        space += EEPROM_LOG_PAGE_RECORDS - log_fill;
+    }
+    return space;
+}
+
+void eeprom_log_flush(void) {
+    if (!dirty_count && !need_snapshot) {
+        return;
+    }
+
+    uint16_t start = timer_read();
+
+    if (need_snapshot || dirty_count > log_space()) {
+        // the image already holds the dirty words
+        if (!write_snapshot()) {
+            // too many literal words to fit, keep them in RAM and retry after the next write
+            stats.overflows++;
+            write_timer = timer_read32();
+            return;
+        }
+    } else {
+        for (uint16_t word = 0; word < EEPROM_LOG_WORDS; word++) {
+            if (dirty[word / 32] & (1UL << (word % 32))) {
+                append_record(word);
+            }
+        }
+        memset(dirty, 0, sizeof(dirty));
+        dirty_count = 0;
+    }
+
+    stats.stall_ms += timer_elapsed(start);
+    stats.flushes++;
+}
+
+void eeprom_log_task(void) {
+    if (held || (!dirty_count && !need_snapshot)) {
+        return;
+    }
+
+    uint32_t elapsed = timer_elapsed32(write_timer);
+    if ((elapsed > EEPROM_LOG_FLUSH_DELAY && matrix_is_idle()) || elapsed > EEPROM_LOG_FLUSH_MAX_DELAY) {
+        eeprom_log_flush();
+    }
+}
+
+bool eeprom_log_is_dirty(void) {
+    return dirty_count || need_snapshot;
+}
+
+void eeprom_log_hold(bool hold) {
+    held = hold;
+}
+
+bool eeprom_log_packs(void) {
+    return literal_words <= EEPROM_LOG_LITERAL_MAX;
+}
+
+uint16_t eeprom_log_erase_count(uint8_t page) {
+    return page < FEE_PAGE_COUNT ? erase_counts[page] : 0;
+}
+
+const eeprom_log_stats_t *eeprom_log_stats(void) {
+    return &stats;
+}
+
+// Snapshot starting at page with all its slots in the following pages, or -1
+static int32_t snapshot_seq(uint8_t page) {
+    uint16_t seq   = page_header(page)->seq;
+    uint8_t  slots = page_header(page)->slots;
+
+    if (!slots || slots > EEPROM_LOG_SNAPSHOT_MAX_PAGES) {
+        return -1;
+    }
+    for (uint8_t slot = 0; slot < slots; slot++) {
+        const fee_page_header_t *header = page_header((page + slot) % FEE_PAGE_COUNT);
+
+        if (header->magic != EEPROM_LOG_MAGIC || header->type != EEPROM_LOG_SNAPSHOT || header->slot != slot || header->slots != slots || header->seq != (uint16_t)(seq + slot)) {
+            return -1;
+        }
+    }
+    return seq;
+}
+
+static uint8_t snapshot_byte(uint8_t first, uint16_t offset) {
+    return page_payload((first + offset / EEPROM_LOG_PAYLOAD) % FEE_PAGE_COUNT)[offset % EEPROM_LOG_PAYLOAD];
+}
+
+static void read_snapshot(uint8_t first) {
+    uint16_t literal = EEPROM_LOG_TAG_BYTES;
+
+    for (uint16_t word = 0; word < EEPROM_LOG_WORDS; word++) {
+        uint8_t tag = (snapshot_byte(first, word / 4) >> (word % 4 * 2)) & 3;
+
+        switch (tag) {
+            case TAG_ZERO:
+                image[word * 2]     = 0x00;
+                image[word * 2 + 1] = 0x00;
+                break;
+            case TAG_ONE:
+                image[word * 2]     = 0x00;
+                image[word * 2 + 1] = 0x01;
+                break;
+            case TAG_ERASED:
+                image[word * 2]     = 0xFF;
+                image[word * 2 + 1] = 0xFF;
+                break;
+            default:
+                image[word * 2]     = snapshot_byte(first, literal++);
+                image[word * 2 + 1] = snapshot_byte(first, literal++);
+                break;
+        }
+    }
+}
+
+static uint16_t count_literals(void) {
+    uint16_t count = 0;
+
+    for (uint16_t word = 0; word < EEPROM_LOG_WORDS; word++) {
+        if (word_tag(image_word(word)) == TAG_LITERAL) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void replay_log_page(uint8_t page) {
+    const fee_record_t *records = (const fee_record_t *)page_payload(page);
+
+    for (log_fill = 0; log_fill < EEPROM_LOG_PAGE_RECORDS; log_fill++) {
+        fee_record_t record = records[log_fill];
+        uint16_t     word   = record.word & 0x3FF;
+
+        if (record.word == 0xFFFF && record.value == 0xFFFF) {
+            break;
+        }
+        // a torn record fails the check, skip it but keep the slot used
+        if (word < EEPROM_LOG_WORDS && (record.word & 0xFC00) == record_check(word, record.value)) {
+            image[word * 2]     = record.value & 0xFF;
+            image[word * 2 + 1] = record.value >> 8;
+        }
+    }
+}
+
+// Rebuild the image and the ring state from flash
+static void log_load(void) {
+    int8_t   snapshot = -1;
+    uint16_t best_seq = 0;
+    uint16_t last_seq = 0;
+    int8_t   last     = -1;
+
+    for (uint8_t page = 0; page < FEE_PAGE_COUNT; page++) {
+        const fee_page_header_t *header = page_header(page);
+
+        if (header->magic != EEPROM_LOG_MAGIC) {
+            continue;
+        }
+        erase_counts[page] = header->erase_count;
+        if (last < 0 || (int16_t)(header->seq - last_seq) > 0) {
+            last     = page;
+            last_seq = header->seq;
+        }
+
+        int32_t seq = snapshot_seq(page);
+        if (seq >= 0 && (snapshot < 0 || (int16_t)(seq - best_seq) > 0)) {
+            snapshot = page;
+            best_seq = seq;
+        }
+    }
+
+    memset(image, 0, sizeof(image));
+    memset(dirty, 0, sizeof(dirty));
+    dirty_count    = 0;
+    literal_words  = 0;
+    snapshot_pages = EEPROM_LOG_SNAPSHOT_MAX_PAGES;
+    log_page       = -1;
+    log_pages      = 0;
+    next_page      = last < 0 ? 0 : (last + 1) % FEE_PAGE_COUNT;
+    next_seq       = last_seq + 1;
+
+    if (snapshot < 0) {
+        need_snapshot = true;
+        return;
+    }
+
+    snapshot_pages = page_header(snapshot)->slots;
+    read_snapshot(snapshot);
+
+    // log pages follow the snapshot in ring order with rising seq; a cut
+    // snapshot may have taken seqs in between, older pages are from past laps
+    uint8_t  page = (snapshot + snapshot_pages) % FEE_PAGE_COUNT;
+    uint16_t seq  = best_seq + snapshot_pages - 1;
+
+    while (log_pages < FEE_PAGE_COUNT - snapshot_pages - EEPROM_LOG_SNAPSHOT_MAX_PAGES && page_valid(page, EEPROM_LOG_RECORDS) && (int16_t)(page_header(page)->seq - seq) > 0) {
+        replay_log_page(page);
+        seq      = page_header(page)->seq;
+        log_page = page;
+        log_pages++;
+        page = (page + 1) % FEE_PAGE_COUNT;
+    }
+
+    // pages past the chain are stale and free, their seq is still taken
+    next_page     = page;
+    need_snapshot = false;
+    literal_words = count_literals();
+}
+
+// back to what flash holds, unflushed writes are dropped
+void eeprom_log_revert(void) {
+    log_load();
+}
+
+// The four driver entry points are linked with --wrap (post_rules.mk), so every
+// call from QMK reaches them whether or not the vendor FEE driver is in
+// the link too; the vendor one is left unreferenced.
+void __wrap_eeprom_driver_init(void) {
+    eflStart(&EFLD1, NULL);
+    log_load();
+    boot_profile_mark(BOOT_EEPROM_LOADED);
+}
+
+void __wrap_eeprom_driver_erase(void) {
+    memset(image, 0, sizeof(image));
+    memset(dirty, 0, sizeof(dirty));
+    dirty_count   = 0;
+    literal_words = 0;
+    need_snapshot = true;
+    write_timer   = timer_read32();
+}
+
+void __wrap_eeprom_read_block(void *buf, const void *addr, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+
+    if (offset >= EEPROM_SIZE) {
+        memset(buf, 0, len);
+        return;
+    }
+    size_t size = MIN(len, EEPROM_SIZE - offset);
+    memcpy(buf, &image[offset], size);
+    memset((uint8_t *)buf + size, 0, len - size);
+}
+
+void __wrap_eeprom_write_block(const void *buf, void *addr, size_t len) {
+    uintptr_t      offset = (uintptr_t)addr;
+    const uint8_t *src    = buf;
+
+    for (size_t i = 0; i < len && offset + i < EEPROM_SIZE; i++) {
+        uint16_t byte = offset + i;
+
+        if (image[byte] == src[i]) {
+            continue;
+        }
+
+        uint16_t word    = byte / 2;
+        bool     literal = word_tag(image_word(word)) == TAG_LITERAL;
+
+        image[byte] = src[i];
+        literal_words += (word_tag(image_word(word)) == TAG_LITERAL) - literal;
+
+        if (!(dirty[word / 32] & (1UL << (word % 32)))) {
+            dirty[word / 32] |= 1UL << (word % 32);
+            dirty_count++;
+        }
+        write_timer = timer_read32();
+    }
+}
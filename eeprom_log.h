@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Flash EEPROM emulation as a log over the FEE page ring.
+//
+// The whole EEPROM lives in a RAM image. Writes only change the image
+// and mark the touched words dirty; eeprom_log_task() flushes them once
+// writes have stopped for EEPROM_LOG_FLUSH_DELAY ms and no key is down,
+// so a burst of VIA slider updates becomes one flush. eeprom_log_hold()
+// keeps the task from flushing, and eeprom_log_revert() drops every write
+// since the last flush by reloading the image from flash; a bulk keymap
+// write uses both so a failed transfer never reaches flash.
+//
+// Flash holds a snapshot of the image followed by log pages of
+// {word, value} records. The snapshot is packed: a 2-bit tag per word
+// says KC_NO, KC_TRNS, 0xFFFF or literal, and only literal words are
+// stored, so mostly empty keymap layers take a page or two whatever
+// EEPROM_SIZE is. An image too dense for (FEE_PAGE_COUNT - 1) / 2
+// pages cannot be saved: eeprom_log_packs() turns false as soon as a
+// write makes it so, and the VIA and bulk keymap writes take such a
+// write back and answer with an error. Anything else that overfills it
+// still goes to the log, but the next snapshot cannot be written: that
+// flush is counted in overflows and the writes since stay in RAM until
+// the image packs again. When the log pages
+// are full the next snapshot is written to the following free pages of
+// the ring, and only then do the old pages become free, so a power loss
+// at any point leaves a complete snapshot behind. Pages are used round
+// the ring in order, which spreads erases evenly; each page header
+// carries its erase count.
+//
+// It replaces the vendor FEE driver through --wrap of the driver entry
+// points (post_rules.mk) with EEPROM_LOG_ENABLE = yes, off by default.
+// The vendor code stays in the link and is not called through QMK, but
+// rdr_lib could still reach it directly; nothing here stops both from
+// erasing the same pages. Pages are erased through the ChibiOS EFL
+// driver by sector, EEPROM_LOG_SECTOR, and programmed in aligned
+// EEPROM_LOG_PROGRAM_UNIT byte units; neither is confirmed for the
+// ES32 port, check both before enabling it on a new board.
+//
+// The page format is not the vendor's: the first boot with the log, and
+// the first boot back on the vendor driver, find no valid EEPROM and
+// start from defaults, the keymap and VIA settings included. Save the
+// keymap in VIA before switching.
+//
+// Without EEPROM_LOG_ENABLE the vendor driver writes through, the calls
+// below do nothing: there is nothing to flush, every image packs, and a
+// bulk keymap write that fails is not rolled back.
+
+// idle time after the last write before flushing
+#ifndef EEPROM_LOG_FLUSH_DELAY
+#    define EEPROM_LOG_FLUSH_DELAY 1000
+#endif
+// flush even with keys held once writes are this old
+#ifndef EEPROM_LOG_FLUSH_MAX_DELAY
+#    define EEPROM_LOG_FLUSH_MAX_DELAY 10000
+#endif
+
+// EFL sector of FEE page `page`, sectors of FEE_PAGE_SIZE from flash address 0
+#ifndef EEPROM_LOG_SECTOR
+#    define EEPROM_LOG_SECTOR(page) (FEE_PAGE_BASE_ADDRESS / FEE_PAGE_SIZE + (page))
+#endif
+// bytes per flash program, at an offset aligned to it
+#ifndef EEPROM_LOG_PROGRAM_UNIT
+#    define EEPROM_LOG_PROGRAM_UNIT 4
+#endif
+
+typedef struct {
+    uint16_t flushes;
+    uint16_t snapshots;
+    uint32_t stall_ms;  // time spent erasing and programming
+    uint16_t overflows; // snapshots that did not fit
+} eeprom_log_stats_t;
+
+#ifdef EEPROM_LOG_ENABLE
+void     eeprom_log_task(void);
+void     eeprom_log_flush(void);
+bool     eeprom_log_is_dirty(void);
+bool     eeprom_log_packs(void);
+void     eeprom_log_hold(bool hold);
+void     eeprom_log_revert(void);
+uint16_t eeprom_log_erase_count(uint8_t page);
+
+const eeprom_log_stats_t *eeprom_log_stats(void);
+#else
+static inline void eeprom_log_task(void) {}
+static inline void eeprom_log_flush(void) {}
+static inline bool eeprom_log_is_dirty(void) {
+    return false;
+}
+static inline bool eeprom_log_packs(void) {
+    return true;
+}
+static inline void eeprom_log_hold(bool hold) {}
+static inline void eeprom_log_revert(void) {}
+static inline uint16_t eeprom_log_erase_count(uint8_t page) {
+    return 0;
+}
+static inline const eeprom_log_stats_t *eeprom_log_stats(void) {
+    static const eeprom_log_stats_t none;
+
+    return &none;
+}
+#endif
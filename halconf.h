@@ -25,5 +25,10 @@
 
 #define HAL_USE_USB TRUE
 #define HAL_USE_PAL TRUE
+#define PAL_USE_CALLBACKS TRUE
+
+#ifdef EEPROM_LOG_ENABLE
+#define HAL_USE_EFL TRUE   // eeprom_log.c erases and programs the FEE pages
+#endif
 
 #include_next <halconf.h>
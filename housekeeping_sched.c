@@ -0,0 +1,93 @@
+#include "quantum.h"
+#include "housekeeping_sched.h"
+#include "matrix_idle.h"
+
+static const housekeeping_job_t *job_table;
+static uint8_t                   job_count;
+static uint32_t                  last_run[HOUSEKEEPING_MAX_JOBS];
+static housekeeping_stats_t      stats[HOUSEKEEPING_MAX_JOBS];
+
+// us clock: the 1 kHz system tick plus the SysTick down-counter within it
+uint32_t housekeeping_now_us(void) {
+#if CH_CFG_ST_TIMEDELTA == 0
+    uint32_t ms;
+    uint32_t count;
+
+    // a tick between the two reads would pair the new count with the old ms
+    do {
+        ms    = timer_read32();
+        count = SysTick->VAL;
+    } while (ms != timer_read32());
+    return ms * 1000 + (SysTick->LOAD - count) * 1000 / (SysTick->LOAD + 1);
+#else
+    return timer_read32() * 1000;
+#endif
+}
+
+static void run_job(uint8_t index, uint32_t now) {
+    const housekeeping_job_t *job   = &job_table[index];
+    housekeeping_stats_t     *stat  = &stats[index];
+    uint32_t                  start = housekeeping_now_us();
+
+    job->run();
+
+    uint32_t took = housekeeping_now_us() - start;
+
+    last_run[index] = now;
+    // the mean stays right once the count saturates, both stop together
+    if (stat->runs < UINT32_MAX) {
+        stat->runs++;
+        stat->total_us += took;
+    }
+    stat->max_us = MAX(stat->max_us, MIN(took, UINT16_MAX));
+    if (took > job->budget && stat->overruns < UINT16_MAX) {
+        stat->overruns++;
+    }
+}
+
+void housekeeping_run(const housekeeping_job_t *jobs, uint8_t count) {
+    uint32_t now        = timer_read32();
+    uint32_t pass_start = housekeeping_now_us();
+    bool     typing     = !matrix_is_idle();
+
+    job_table = jobs;
+    job_count = MIN(count, HOUSEKEEPING_MAX_JOBS);
+
+    for (uint8_t priority = HOUSEKEEPING_CRITICAL; priority <= HOUSEKEEPING_BACKGROUND; priority++) {
+        for (uint8_t i = 0; i < job_count; i++) {
+            if (jobs[i].priority != priority) {
+                continue;
+            }
+
+            uint32_t waited = now - last_run[i];
+            if (jobs[i].period && waited < jobs[i].period) {
+                continue;
+            }
+
+            bool spent = housekeeping_now_us() - pass_start > HOUSEKEEPING_PASS_BUDGET || (priority == HOUSEKEEPING_BACKGROUND && typing);
+            if (priority != HOUSEKEEPING_CRITICAL && spent && waited < (uint32_t)jobs[i].period + HOUSEKEEPING_MAX_DEFER) {
+                if (stats[i].deferred < UINT16_MAX) {
+                    stats[i].deferred++;
+                }
+                continue;
+            }
+            run_job(i, now);
+        }
+    }
+}
+
+uint8_t housekeeping_job_count(void) {
+    return job_count;
+}
+
+const housekeeping_job_t *housekeeping_job(uint8_t index) {
+    return index < job_count ? &job_table[index] : NULL;
+}
+
+const housekeeping_stats_t *housekeeping_stats(uint8_t index) {
+    return index < job_count ? &stats[index] : NULL;
+}
+
+void housekeeping_stats_clear(void) {
+    memset(stats, 0, sizeof(stats));
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Housekeeping jobs run by period, priority and time budget.
+//
+// Matrix scanning and report sending happen outside housekeeping, so
+// every millisecond spent here delays the next scan. Each pass runs the
+// due jobs from the highest priority down. Once a pass has used
+// HOUSEKEEPING_PASS_BUDGET us, or while a key is down, the lower
+// priorities wait for a later pass. They wait at most
+// HOUSEKEEPING_MAX_DEFER ms. Per job run time is timed in us and kept
+// for the diag raw HID command.
+
+enum housekeeping_priority {
+    HOUSEKEEPING_CRITICAL, // every due pass, never deferred
+    HOUSEKEEPING_NORMAL,
+    HOUSEKEEPING_BACKGROUND, // also held back while a key is down
+};
+
+typedef struct {
+    void (*run)(void);
+    uint16_t period; // ms, 0 = every pass
+    uint8_t  priority;
+    uint16_t budget; // us, a longer run counts as an overrun
+} housekeeping_job_t;
+
+typedef struct {
+    uint32_t runs;
+    uint64_t total_us; // a period 0 job fills 32 bits within hours
+    uint16_t max_us;
+    uint16_t overruns;
+    uint16_t deferred;
+} housekeeping_stats_t;
+
+#ifndef HOUSEKEEPING_MAX_JOBS
+#    define HOUSEKEEPING_MAX_JOBS 12
+#endif
+#ifndef HOUSEKEEPING_PASS_BUDGET
+#    define HOUSEKEEPING_PASS_BUDGET 500
+#endif
+#ifndef HOUSEKEEPING_MAX_DEFER
+#    define HOUSEKEEPING_MAX_DEFER 100
+#endif
+
+void housekeeping_run(const housekeeping_job_t *jobs, uint8_t count);
+
+uint8_t                     housekeeping_job_count(void);
+const housekeeping_job_t   *housekeeping_job(uint8_t index);
+const housekeeping_stats_t *housekeeping_stats(uint8_t index);
+void                        housekeeping_stats_clear(void);
+
+// system tick plus SysTick, wraps after 71 minutes
+uint32_t housekeeping_now_us(void);
@@ -0,0 +1,145 @@
+#include "quantum.h"
+#include "key_queue.h"
+#include "report_batch.h"
+
+typedef enum {
+    KQ_PRESS,
+    KQ_RELEASE,
+    KQ_DELAY,
+    KQ_LAYER_ON,
+    KQ_LAYER_OFF,
+} key_queue_type_t;
+
+typedef struct {
+    uint8_t  type;
+    uint16_t arg;
+} key_queue_action_t;
+
+static key_queue_action_t queue[KEY_QUEUE_SIZE];
+static uint8_t            queue_head  = 0;
+static uint8_t            queue_count = 0;
+static bool               delay_started = false;
+static uint32_t           delay_timer;
+static uint16_t           report_timer;
+
+static bool key_queue_post(uint8_t type, uint16_t arg) {
+    if (queue_count >= KEY_QUEUE_SIZE) {
+        return false;
+    }
+    queue[(queue_head + queue_count) % KEY_QUEUE_SIZE] = (key_queue_action_t){.type = type, .arg = arg};
+    queue_count++;
+    return true;
+}
+
+bool key_queue_press(uint16_t keycode) {
+    return key_queue_post(KQ_PRESS, keycode);
+}
+
+bool key_queue_release(uint16_t keycode) {
+    return key_queue_post(KQ_RELEASE, keycode);
+}
+
+bool key_queue_tap(uint16_t keycode) {
+    // both halves or nothing, a lone press would stick
+    if (queue_count + 2 > KEY_QUEUE_SIZE) {
+        return false;
+    }
+    return key_queue_press(keycode) && key_queue_release(keycode);
+}
+
+bool key_queue_delay(uint16_t ms) {
+    return key_queue_post(KQ_DELAY, ms);
+}
+
+bool key_queue_layer_on(uint8_t layer) {
+    return key_queue_post(KQ_LAYER_ON, layer);
+}
+
+bool key_queue_layer_off(uint8_t layer) {
+    return key_queue_post(KQ_LAYER_OFF, layer);
+}
+
+bool key_queue_is_busy(void) {
+    return queue_count > 0;
+}
+
+static void key_queue_pop(void) {
+    queue_head = (queue_head + 1) % KEY_QUEUE_SIZE;
+    queue_count--;
+}
+
+// Folds the run of presses and releases at the head of the queue into one report
+static void key_queue_send_reports(void) {
+    uint8_t touched[KEY_QUEUE_SIZE];
+    uint8_t touched_count = 0;
+
+    while (queue_count > 0) {
+        key_queue_action_t *action = &queue[queue_head];
+
+        if (action->type != KQ_PRESS && action->type != KQ_RELEASE) {
+            break;
+        }
+
+        // a key pressed and released in one report would never reach the host
+        uint8_t key = QK_MODS_GET_BASIC_KEYCODE(action->arg);
+        if (memchr(touched, key, touched_count)) {
+            break;
+        }
+
+        if (!(action->type == KQ_PRESS ? report_batch_add(action->arg) : report_batch_del(action->arg))) {
+            if (touched_count > 0) {
+                break;
+            }
+            // consumer and system keys, these send on their own
+            if (action->type == KQ_PRESS) {
+                register_code16(action->arg);
+            } else {
+                unregister_code16(action->arg);
+            }
+            key_queue_pop();
+            return;
+        }
+
+        touched[touched_count++] = key;
+        key_queue_pop();
+    }
+
+    if (touched_count > 0) {
+        send_keyboard_report();
+    }
+}
+
+void key_queue_task(void) {
+    while (queue_count > 0) {
+        key_queue_action_t *action = &queue[queue_head];
+
+        switch (action->type) {
+            case KQ_PRESS:
+            case KQ_RELEASE:
+                if (timer_elapsed(report_timer) < KEY_QUEUE_REPORT_INTERVAL) {
+                    return;
+                }
+                key_queue_send_reports();
+                report_timer = timer_read();
+                continue;
+            case KQ_DELAY:
+                if (!delay_started) {
+                    delay_started = true;
+                    delay_timer   = timer_read32();
+                }
+                if (timer_elapsed32(delay_timer) < action->arg) {
+                    return; // come back on the next housekeeping pass
+                }
+                delay_started = false;
+                break;
+            case KQ_LAYER_ON:
+                layer_on(action->arg);
+                break;
+            case KQ_LAYER_OFF:
+                layer_off(action->arg);
+                break;
+        }
+
+        key_queue_pop();
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Deferred key actions for macros that need a pause between steps.
+// Actions run in order from housekeeping_task_user, so a delay never
+// blocks matrix scanning the way wait_ms() does.
+//
+// Runs of presses and releases are folded into one keyboard report as
+// long as no key appears twice in the run, and reports are spaced at
+// least KEY_QUEUE_REPORT_INTERVAL ms apart. A tap_code16(C(KC_C)) costs
+// four reports, a queued tap two, and the release of one tap shares a
+// report with the press of the next.
+
+#ifndef KEY_QUEUE_SIZE
+#    define KEY_QUEUE_SIZE 16
+#endif
+// one host poll, reports closer than that would only queue up
+#ifndef KEY_QUEUE_REPORT_INTERVAL
+#    define KEY_QUEUE_REPORT_INTERVAL 1
+#endif
+
+bool key_queue_press(uint16_t keycode);
+bool key_queue_release(uint16_t keycode);
+bool key_queue_tap(uint16_t keycode);
+bool key_queue_delay(uint16_t ms);
+bool key_queue_layer_on(uint8_t layer);
+bool key_queue_layer_off(uint8_t layer);
+
+bool key_queue_is_busy(void);
+void key_queue_task(void);
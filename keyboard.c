@@ -16,6 +16,25 @@
  */
 
 #include "../../lib/rdr_lib/rdr_common.h"
+#include "key_queue.h"
+#include "tap_resolve.h"
+#include "tap_learn.h"
+#include "user_config.h"
+#include "report_batch.h"
+#include "keycode_cache.h"
+#include "eeprom_log.h"
+#include "power_state.h"
+#include "housekeeping_sched.h"
+#include "qk61_trace.h"
+#include "wireless_queue.h"
+#include "boot_profile.h"
+#include "qk61_bulk.h"
+#ifdef CHORD_ENABLE
+#    include "chord.h"
+#endif
+#ifdef MOD_REMAP_ENABLE
+#    include "mod_remap.h"
+#endif
 
 void matrix_io_delay(void) {
 }
@@ -52,6 +71,10 @@ led_config_t g_led_config = { {
 } };
 
 bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
+    // User_Led_Show paints every indicator LED, once on the last chunk of the frame is enough
+    if (led_max < RGB_MATRIX_LED_COUNT) {
+        return false;
+    }
     User_Led_Show();
     return false;
 }
@@ -59,6 +82,7 @@ bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
 void notify_usb_device_state_change_user(enum usb_device_state usb_device_state)  {
     if (Keyboard_Info.Key_Mode == QMK_USB_MODE) {
         if(usb_device_state == USB_DEVICE_STATE_CONFIGURED) {
+            boot_profile_mark(BOOT_USB_READY);
             Usb_If_Ok = true;//usb枚举完成
             Usb_If_Ok_Led = true;
             Usb_If_Ok_Delay = 0;
@@ -72,22 +96,102 @@ void notify_usb_device_state_change_user(enum usb_device_state usb_device_state)
     }
 }
 
+// period ms, priority, budget us
+static const housekeeping_job_t housekeeping_jobs[] = {
+    {User_Keyboard_Reset, 0, HOUSEKEEPING_CRITICAL, 100},
+    {es_chibios_user_idle_loop_hook, 0, HOUSEKEEPING_CRITICAL, 300},
+    {key_queue_task, 0, HOUSEKEEPING_CRITICAL, 100},
+    {boot_profile_task, 0, HOUSEKEEPING_CRITICAL, 100},
+    {wireless_queue_task, 0, HOUSEKEEPING_CRITICAL, 200},
+#ifdef CHORD_ENABLE
+    {chord_task, 0, HOUSEKEEPING_CRITICAL, 50},
+#endif
+#ifdef MOD_REMAP_ENABLE
+    {mod_remap_task, 0, HOUSEKEEPING_CRITICAL, 50},
+#endif
+    {eeprom_log_task, 100, HOUSEKEEPING_BACKGROUND, 30000}, // a flush may erase pages
+    {qk61_bulk_task, 100, HOUSEKEEPING_BACKGROUND, 2000},
+    {tap_learn_task, 1000, HOUSEKEEPING_BACKGROUND, 1000},
+};
+
+_Static_assert(ARRAY_SIZE(housekeeping_jobs) <= HOUSEKEEPING_MAX_JOBS, "raise HOUSEKEEPING_MAX_JOBS");
+
 void housekeeping_task_user(void) {
-    User_Keyboard_Reset();
-    es_chibios_user_idle_loop_hook();
+    housekeeping_run(housekeeping_jobs, ARRAY_SIZE(housekeeping_jobs));
+    // last, it may sleep the main loop for a tick or until the next key
+    power_task();
 }
 
 void board_init(void) {
+    boot_profile_init();
     User_Keyboard_Init();
 }
 
+void keyboard_pre_init_user(void) {
+    boot_profile_mark(BOOT_PRE_INIT);
+}
+
 void keyboard_post_init_user(void) {
+    boot_profile_mark(BOOT_POST_INIT);
     User_Keyboard_Post_Init();
+    boot_profile_mark(BOOT_VENDOR_INIT);
+    // lighting waits for the first report, scanning and sending come first
+    boot_profile_defer_rgb();
+    user_config_init();
+    tap_learn_init();
+    keycode_cache_init();
+#ifdef CHORD_ENABLE
+    chord_init();
+#endif
+    boot_profile_mark(BOOT_INIT_DONE);
+}
+
+void eeconfig_init_user(void) {   /*EEPROM cleared (U_EE_CLR or VIA reset)*/
+    keycode_cache_invalidate();
+    // QMK leaves the VIA custom config as it was, defaults are all zero
+    memset(&user_config, 0, sizeof(user_config));
+    user_config_save();
+    tap_learn_init();
+}
+
+bool shutdown_user(bool jump_to_bootloader) {
+    eeprom_log_flush();
+    return true;
+}
+
+// ahead of tapping and tap dance, keys held by a chord or remapped never reach them
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+#ifdef CHORD_ENABLE
+    if (!process_chord(record)) {
+        return false;
+    }
+#endif
+#ifdef MOD_REMAP_ENABLE
+    if (!process_mod_remap(keycode, record)) {
+        return false;
+    }
+#endif
+    return true;
 }
 
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {   /*键盘只要有按键按下就会调用此函数*/
+    TRACE_KEY(TRACE_RECORD_ENTER, record->event.key);
     Usb_Change_Mode_Delay = 0;                                      /*只要有按键就不会进入休眠*/
     Usb_Change_Mode_Wakeup = false;
 
-    return Key_Value_Dispose(keycode, record);
+    tap_resolve_record(keycode, record);
+    tap_learn_record(keycode, record);
+
+    bool handled = Key_Value_Dispose(keycode, record) && process_report_batch(keycode, record);
+
+    TRACE_KEY(TRACE_RECORD_EXIT, record->event.key);
+    return handled;
+}
+
+void post_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    // the report of this event has been sent by now
+    trace_report_sent(record->event.pressed);
+    if (record->event.pressed) {
+        boot_profile_report();
+    }
 }
@@ -0,0 +1,68 @@
+#include "quantum.h"
+#include "dynamic_keymap.h"
+#include "keycode_cache.h"
+
+static uint16_t      effective[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t       effective_layer[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t       resolved[MATRIX_ROWS][MATRIX_COLS]; // generation of the entry, 0 = none
+static uint8_t       generation = 1;
+static layer_state_t cached_state;
+static layer_state_t cached_default_state;
+
+void keycode_cache_init(void) {
+    keycode_cache_invalidate();
+}
+
+// one byte compare per lookup, entries of older generations are stale
+void keycode_cache_invalidate(void) {
+    if (++generation == 0) {
+        memset(resolved, 0, sizeof(resolved));
+        generation = 1;
+    }
+    cached_state         = layer_state;
+    cached_default_state = default_layer_state;
+}
+
+// the same walk as layer_switch_get_layer, once per key and generation
+static void keycode_cache_resolve(uint8_t row, uint8_t col) {
+    layer_state_t state   = layer_state | default_layer_state;
+    uint8_t       layer   = get_highest_layer(default_layer_state);
+    uint16_t      keycode = dynamic_keymap_get_keycode(layer, row, col); // all transparent
+
+    for (int8_t i = DYNAMIC_KEYMAP_LAYER_COUNT - 1; i >= 0; i--) {
+        if (state & ((layer_state_t)1 << i)) {
+            uint16_t found = dynamic_keymap_get_keycode(i, row, col);
+
+            if (found != KC_TRNS) {
+                layer   = i;
+                keycode = found;
+                break;
+            }
+        }
+    }
+    effective[row][col]       = keycode;
+    effective_layer[row][col] = layer;
+    resolved[row][col]        = generation;
+}
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    uint8_t row = key.row;
+    uint8_t col = key.col;
+
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+        return KC_NO;
+    }
+    if (cached_state != layer_state || cached_default_state != default_layer_state) {
+        keycode_cache_invalidate();
+    }
+    if (resolved[row][col] != generation) {
+        keycode_cache_resolve(row, col);
+    }
+    if (layer == effective_layer[row][col]) {
+        return effective[row][col];
+    }
+    if (layer > effective_layer[row][col] && ((layer_state | default_layer_state) & ((layer_state_t)1 << layer))) {
+        return KC_TRNS;
+    }
+    return dynamic_keymap_get_keycode(layer, row, col);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include "quantum.h"
+
+// The keycode each key resolves to under the current layer state.
+//
+// QMK's layer walk asks keymap_key_to_keycode() for every active layer
+// from the top down until a key is not transparent. The first walk for
+// a key after the layer state changes or VIA writes the keymap reads the
+// dynamic keymap as before and remembers the layer and keycode it
+// settled on; every later walk is served from that entry, one array
+// read per call. Layers above the resolved one are transparent by
+// construction. Lookups of other layers, such as the release of a key
+// through QMK's layer cache after its layer went off, read the keymap.
+
+void keycode_cache_init(void);
+void keycode_cache_invalidate(void);
@@ -1,5 +1,9 @@
 #include QMK_KEYBOARD_H
 #include "../../../lib/rdr_lib/rdr_common.h"
+#include "key_queue.h"
+#include "report_batch.h"
+#include "tap_resolve.h"
+#include "qk61_trace.h"
 
 // --- Layers and Tap Dance ---
 
@@ -29,12 +33,12 @@ enum {
 
 // macOS Lock on hold, RAlt (Option) on tap
 void td_maclock_finished(tap_dance_state_t *state, void *user_data) {
-    state->pressed ? tap_code16(C(G(KC_Q))) : tap_code(KC_RALT);
+    state->pressed ? report_batch_tap(C(G(KC_Q))) : report_batch_tap(KC_RALT);
 }
 
 // puntoSwitcher for macOS: Ctrl + Cmd + Backslash (shortcut in puntoSwitcher), Backslash on hold
 void td_switch_finished(tap_dance_state_t *state, void *user_data) {
-    state->pressed ? tap_code(KC_BSLS)  : tap_code16(C(G(KC_BSLS)));
+    state->pressed ? report_batch_tap(KC_BSLS) : report_batch_tap(C(G(KC_BSLS)));
 }
 
 // puntoSwitcher for macOS: Ctrl + Cmd + Alt to change case of selected text (abc -> ABC)
@@ -42,21 +46,29 @@ void td_case_finished(tap_dance_state_t *state, void *user_data) {
     if (state->pressed) {
         tap_code(KC_RSFT);
     } else {
-        tap_code16(S(A(KC_LEFT))); // select word to left
-        tap_code16(C(G(KC_LALT))); // change case
-        wait_ms(400);
-        tap_code16(KC_RIGHT);      // unselect word (right)
-        tap_code16(KC_SPC);        // add space
+        key_queue_tap(S(A(KC_LEFT))); // select word to left
+        key_queue_tap(C(G(KC_LALT))); // change case
+        key_queue_delay(400);
+        key_queue_tap(KC_RIGHT);      // unselect word (right)
+        key_queue_tap(KC_SPC);        // add space
     }
 }
 
 // Tap Dance table
 tap_dance_action_t tap_dance_actions[] = {
-    [TD_MAC_LOCK] = ACTION_TAP_DANCE_FN(td_maclock_finished),
-    [TD_SWITCH] = ACTION_TAP_DANCE_FN(td_switch_finished),
-    [TD_CASE] = ACTION_TAP_DANCE_FN(td_case_finished),
+    [TD_MAC_LOCK] = ACTION_TAP_DANCE_TRACED(td_maclock_finished, NULL),
+    [TD_SWITCH] = ACTION_TAP_DANCE_TRACED(td_switch_finished, NULL),
+    [TD_CASE] = ACTION_TAP_DANCE_TRACED(td_case_finished, NULL),
 };
 
+// Early resolution modes (see tap_resolve.h)
+const uint8_t PROGMEM td_resolve_modes[] = {
+    [TD_MAC_LOCK] = TD_EARLY_TAP,
+    [TD_SWITCH]   = TD_EARLY_TAP,
+    [TD_CASE]     = TD_EARLY_TAP,
+};
+const uint8_t td_resolve_modes_count = ARRAY_SIZE(td_resolve_modes);
+
 // --- Layers ---
 const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
     
@@ -1,5 +1,15 @@
 #include QMK_KEYBOARD_H
 #include "../../../lib/rdr_lib/rdr_common.h"
+#include "key_queue.h"
+#include "report_batch.h"
+#include "tap_resolve.h"
+#include "qk61_trace.h"
+#ifdef MOD_REMAP_ENABLE
+#    include "mod_remap.h"
+#endif
+#ifdef CHORD_ENABLE
+#    include "chord.h"
+#endif
 
 // --- Layers and Tap Dance ---
 
@@ -8,8 +18,7 @@ enum Layers {
     _WIN,                       // [0] Base Windows layer
     _NUM,                       // [1] Numpad layer
     _NAV,                       // [2] Navigation layer
-    _FUNC,                       // [3] Layer with F-keys, RGB control and media
-    _ALT                        // [4] Layer with basic ctrl+ commands to alt+ commands (alt+c -> ctrl+c, alt+v -> ctrl+v, etc.)
+    _FUNC                       // [3] Layer with F-keys, RGB control and media
 // The _FUNC layer must be at position [3] for correct connection mode LED indication (BLE, wired, 2.4G)
 };
 
@@ -20,8 +29,6 @@ enum {
     TD_NUM_OFF,                 // Turn off persistent _NUM layer
     TD_WIN_LOCK,                // Windows lock or App/Menu key
     TD_CASE,                     // for puntoSwitcher - Ctrl+Cmd+Alt to change case of selected text (abc -> ABC)
-    TD_ALT_TAB,
-    TD_ALT_LAYER,
     TD_CALC,
     TD_CALC_OFF
 };
@@ -74,42 +81,15 @@ void td_calc_finished(tap_dance_state_t *state, void *user_data) {
 // --- Close Calculator + deactivate numpad layer ---
 void td_calc_off_finished(tap_dance_state_t *state, void *user_data) {
     if (state->count == 1) {
-        tap_code16(ALT_F4);
+        report_batch_tap(ALT_F4);
         layer_off(_NUM);
     }
 }
 
-// --- Tap Dance for left Alt ---
-void td_alt_layer_finished(tap_dance_state_t *state, void *user_data) {
-    if (state->pressed) {
-        layer_on(_ALT); // Hold → toggle _ALT layer
-    } else if (state->count == 1) {
-        tap_code(KC_LALT); // Tap → left Alt
-    }
-}
-
-void td_alt_layer_reset(tap_dance_state_t *state, void *user_data) {
-        unregister_code(KC_LALT);
-        layer_off(_ALT); // release → toggle layer _ALT off
-}
-
-// --- Tap Dance for Tab in layer _ALT ---
-void td_alt_tab_finished(tap_dance_state_t *state, void *user_data) {
-    // if (state->pressed) {
-    if (state->count == 1) {
-        register_code(KC_LALT); // Hold Alt for Alt+Tab
-        tap_code(KC_TAB); // Send Tab
-    }
-}
-
-void td_alt_tab_reset(tap_dance_state_t *state, void *user_data) {
-    // do nothing
-}
-
 // CapsLock modifier
 void td_win_caps_finished(tap_dance_state_t *state, void *user_data) {
     if (state->count == 1 && !state->pressed) {
-        tap_code16(WIN_LANG);   // 1 tap: change language
+        report_batch_tap(WIN_LANG); // 1 tap: change language
     } else if (state->count == 2 && !state->pressed) {
         tap_code(KC_CAPS);      // 2 taps: CapsLock
     } else if (state->count == 1 && state->pressed) {
@@ -149,7 +129,7 @@ void td_num_layer_off(tap_dance_state_t *state, void *user_data) {
 
 // Windows Lock on hold, App/Menu on tap
 void td_winlock_finished(tap_dance_state_t *state, void *user_data) {
-    state->pressed ? tap_code16(WIN_LOCK) : tap_code(KC_APP);
+    state->pressed ? report_batch_tap(WIN_LOCK) : report_batch_tap(KC_APP);
 }
 
 // puntoSwitcher for win: shortcut Ctrl + Cmd + Alt + \ to change case of selected text (abc -> ABC)
@@ -157,27 +137,63 @@ void td_case_finished(tap_dance_state_t *state, void *user_data) {
     if (state->pressed) {
         tap_code(KC_RSFT);
     } else {
-        tap_code16(C(S(KC_LEFT)));    // select word to left
-        tap_code16(C(S(A(KC_BSLS)))); // change case
-        wait_ms(500);
-        tap_code16(KC_RIGHT);         // unselect word (right)
-        tap_code16(KC_SPC);           // add space
+        key_queue_tap(C(S(KC_LEFT)));    // select word to left
+        key_queue_tap(C(S(A(KC_BSLS)))); // change case
+        key_queue_delay(500);
+        key_queue_tap(KC_RIGHT);         // unselect word (right)
+        key_queue_tap(KC_SPC);           // add space
     }
 }
 
 
 // Tap Dance table
 tap_dance_action_t tap_dance_actions[] = {
-    [TD_WIN_CAPS]  = ACTION_TAP_DANCE_FN_ADVANCED(NULL, td_win_caps_finished, td_win_caps_reset),
-    [TD_NUM_TAB]   = ACTION_TAP_DANCE_FN_ADVANCED(NULL, td_num_tab_finished,  td_num_tab_reset),
-    [TD_NUM_OFF]   = ACTION_TAP_DANCE_FN(td_num_layer_off),
-    [TD_WIN_LOCK]  = ACTION_TAP_DANCE_FN(td_winlock_finished),
-    [TD_CASE]      = ACTION_TAP_DANCE_FN(td_case_finished),
-    [TD_ALT_LAYER] = ACTION_TAP_DANCE_FN_ADVANCED(NULL, td_alt_layer_finished, td_alt_layer_reset),
-    [TD_ALT_TAB]   = ACTION_TAP_DANCE_FN_ADVANCED(NULL, td_alt_tab_finished, td_alt_tab_reset),
-    [TD_CALC]      = ACTION_TAP_DANCE_FN(td_calc_finished),
-    [TD_CALC_OFF]  = ACTION_TAP_DANCE_FN(td_calc_off_finished),
+    [TD_WIN_CAPS]  = ACTION_TAP_DANCE_TRACED(td_win_caps_finished, td_win_caps_reset),
+    [TD_NUM_TAB]   = ACTION_TAP_DANCE_TRACED(td_num_tab_finished, td_num_tab_reset),
+    [TD_NUM_OFF]   = ACTION_TAP_DANCE_TRACED(td_num_layer_off, NULL),
+    [TD_WIN_LOCK]  = ACTION_TAP_DANCE_TRACED(td_winlock_finished, NULL),
+    [TD_CASE]      = ACTION_TAP_DANCE_TRACED(td_case_finished, NULL),
+    [TD_CALC]      = ACTION_TAP_DANCE_TRACED(td_calc_finished, NULL),
+    [TD_CALC_OFF]  = ACTION_TAP_DANCE_TRACED(td_calc_off_finished, NULL),
+};
+
+// Early resolution modes (see tap_resolve.h)
+// TD_WIN_CAPS, TD_NUM_TAB and TD_NUM_OFF have a double tap, so they still wait for TAPPING_TERM
+const uint8_t PROGMEM td_resolve_modes[] = {
+    [TD_WIN_LOCK]  = TD_EARLY_TAP,
+    [TD_CASE]      = TD_EARLY_TAP,
+    [TD_CALC]      = TD_EARLY_TAP,
+    [TD_CALC_OFF]  = TD_EARLY_TAP,
+};
+const uint8_t td_resolve_modes_count = ARRAY_SIZE(td_resolve_modes);
+
+#ifdef MOD_REMAP_ENABLE
+// Left Alt overrides (see mod_remap.h), Alt+letter to Ctrl+letter in place of the old _ALT layer
+const uint16_t PROGMEM lalt_overrides[] = {
+    [KC_ESC] = KC_GRV,  // the QK_GESC key, as on the old _ALT layer
+    [KC_1]   = CTRL_1,  [KC_2] = CTRL_2, [KC_3] = CTRL_3, [KC_4] = CTRL_4, [KC_5] = CTRL_5,
+    [KC_6]   = CTRL_6,  [KC_7] = CTRL_7, [KC_8] = CTRL_8, [KC_9] = CTRL_9, [KC_0] = CTRL_0,
+    [KC_Q]   = ALT_F4,  [KC_W] = CTRL_W, [KC_R] = CTRL_R, [KC_T] = CTRL_T, [KC_Y] = CTRL_Y,
+    [KC_A]   = CTRL_A,  [KC_S] = CTRL_S, [KC_F] = CTRL_F,
+    [KC_Z]   = CTRL_Z,  [KC_X] = CTRL_X, [KC_C] = CTRL_C, [KC_V] = CTRL_V, [KC_B] = PST_VAL,
+    [KC_TAB] = ALT_TAB, // Alt stays down, Tab again cycles windows
 };
+const uint8_t lalt_overrides_count = ARRAY_SIZE(lalt_overrides);
+
+const uint16_t PROGMEM lalt_td_overrides[] = {
+    [TD_NUM_TAB] = ALT_TAB,
+};
+const uint8_t lalt_td_overrides_count = ARRAY_SIZE(lalt_td_overrides);
+#endif
+
+#ifdef CHORD_ENABLE
+// Chords by matrix position (row, col of info.json), on every layer
+const chord_t PROGMEM chords[] = {
+    {KC_ESC, 0, {CHORD_KEY(3, 7), CHORD_KEY(3, 8)}},        // J + K
+    {C(KC_BSPC), 0, {CHORD_KEY(3, 3), CHORD_KEY(3, 4)}},    // D + F: delete word
+};
+const uint8_t chords_count = ARRAY_SIZE(chords);
+#endif
 
 // --- Layers ---
 const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
@@ -186,7 +202,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         TD(TD_NUM_TAB),    KC_Q,     KC_W,     KC_E,    KC_R,     KC_T,     KC_Y,    KC_U,    KC_I,    KC_O,    KC_P,    KC_LBRC, KC_RBRC, KC_BSLS,
         TD(TD_WIN_CAPS),   KC_A,     KC_S,     KC_D,    KC_F,     KC_G,     KC_H,    KC_J,    KC_K,    KC_L,    KC_SCLN, KC_QUOT,          KC_ENT,
         KC_LSFT,           KC_Z,     KC_X,     KC_C,    KC_V,     KC_B,     KC_N,    KC_M,    KC_COMM, KC_DOT,  KC_SLSH,                   KC_RSFT,
-        KC_LCTL,           KC_LGUI,  TD(TD_ALT_LAYER),                     KC_SPC,                    LT(_NAV, KC_RALT), TD(TD_WIN_LOCK),  KC_RCTL, MO(_FUNC)
+        KC_LCTL,           KC_LGUI,  KC_LALT,                              KC_SPC,                    LT(_NAV, KC_RALT), TD(TD_WIN_LOCK),  KC_RCTL, MO(_FUNC)
     ),
 
     [_NUM] = LAYOUT_tkl_ansi(
@@ -211,13 +227,5 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         LOGO_MOD,          LOGO_HUD, LOGO_HUI, _______, _______,  _______,  _______, _______, _______, _______, RGB_HUD, RGB_HUI,          QK_BAT,
         LOGO_VAI,          RGB_VAD,  RGB_VAI,  KC_CALC, _______,  _______,  _______, RGB_RMOD,                  RGB_MOD, KC_MPRV, KC_MNXT, KC_MPLY, 
         LOGO_VAD,          LOGO_SPD, LOGO_SPI,                    RGB_TOG,                             KC_VOLD, KC_VOLU, KC_MUTE,          _______
-    ),
-
-    [_ALT] = LAYOUT_tkl_ansi(
-        KC_GRV,            CTRL_1,   CTRL_2,   CTRL_3,  CTRL_4,   CTRL_5,   CTRL_6,  CTRL_7,  CTRL_8,  CTRL_9,  CTRL_0,  _______, _______, _______,
-        TD(TD_ALT_TAB),    ALT_F4,   CTRL_W,   _______, CTRL_R,   CTRL_T,   CTRL_Y,  _______, _______, _______, _______, _______, _______, _______,
-        _______,           CTRL_A,   CTRL_S,   _______, CTRL_F,   _______,  _______, _______, _______, _______, _______, _______,          _______,
-        KC_LSFT,           CTRL_Z,   CTRL_X,   CTRL_C,  CTRL_V,   PST_VAL,  _______, _______, _______, _______, _______,                   _______,
-        _______,           _______,  _______,                     _______,                             _______, _______,          _______, _______
     )
 };
@@ -1,4 +1,15 @@
 # added combo support for win keymap
 # COMBO_ENABLE = yes
-DYNAMIC_KEYMAP_LAYER_COUNT = 5
+# chords by matrix position instead of combos, see chord.h
+# CHORD_ENABLE = yes
+# left Alt overrides in place of the _ALT layer, see mod_remap.h
+MOD_REMAP_ENABLE = yes
+# 8 layers with the EEPROM log, but its flash holds about 622 keycodes
+# other than KC_NO/KC_TRNS: VIA writes past that are refused without an
+# error in the app, see the readme
+ifeq ($(strip $(EEPROM_LOG_ENABLE)), yes)
+    DYNAMIC_KEYMAP_LAYER_COUNT = 8
+else
+    DYNAMIC_KEYMAP_LAYER_COUNT = 5
+endif
 GRAVE_ESC_ENABLE = yes
\ No newline at end of file
@@ -1,6 +1,10 @@
 // settings for combo support
 // #define COMBO_TERM 25                // 50 ms - default delay for Combos
+#ifdef EEPROM_LOG_ENABLE
+#define DYNAMIC_KEYMAP_LAYER_COUNT 8    // the packed EEPROM log has room for them
+#else
 #define DYNAMIC_KEYMAP_LAYER_COUNT 5
+#endif
 
 
 #define GRAVE_ESC_ALT_OVERRIDE
@@ -0,0 +1,422 @@
+// Generated by util/gen_led_tables.py from g_led_config, do not edit.
+#pragma once
+
+#define LED_TABLES_LED_COUNT 64
+#define LED_TABLES_KEY_COUNT 61
+
+// g_led_config.point the distances are from, checked at run time
+static const uint8_t led_points[LED_TABLES_LED_COUNT][2] = {
+    {  0, 10}, { 16, 10}, { 32, 10}, { 48, 10}, { 64, 10}, { 80, 10}, { 96, 10}, {112, 10},
+    {128, 10}, {144, 10}, {160, 10}, {176, 10}, {192, 10}, {220, 10}, {  4, 20}, { 24, 20},
+    { 40, 20}, { 56, 20}, { 72, 20}, { 88, 20}, {104, 20}, {120, 20}, {136, 20}, {152, 20},
+    {168, 20}, {184, 20}, {200, 20}, {222, 20}, {  4, 30}, { 28, 30}, { 44, 30}, { 60, 30},
+    { 76, 30}, { 92, 30}, {108, 30}, {124, 30}, {140, 30}, {156, 30}, {172, 30}, {188, 30},
+    {216, 30}, {  8, 40}, { 35, 40}, { 51, 40}, { 67, 40}, { 83, 40}, { 99, 40}, {115, 40},
+    {131, 40}, {147, 40}, {163, 40}, {180, 40}, {224, 40}, {  0, 50}, { 20, 50}, { 40, 50},
+    {110, 50}, {176, 50}, {192, 50}, {208, 40}, {224, 40}, {225, 65}, {225, 65}, {225, 65},
+};
+
+static const uint8_t led_hue_rgb[256][3] = {
+    {255,   0,   0}, {255,   6,   0}, {255,  12,   0}, {255,  18,   0}, {255,  24,   0}, {255,  30,   0}, {255,  36,   0}, {255,  42,   0},
+    {255,  48,   0}, {255,  54,   0}, {255,  60,   0}, {255,  66,   0}, {255,  72,   0}, {255,  78,   0}, {255,  84,   0}, {255,  90,   0},
+    {255,  96,   0}, {255, 102,   0}, {255, 108,   0}, {255, 114,   0}, {255, 120,   0}, {255, 126,   0}, {255, 132,   0}, {255, 138,   0},
+    {255, 144,   0}, {255, 150,   0}, {255, 156,   0}, {255, 162,   0}, {255, 168,   0}, {255, 174,   0}, {255, 180,   0}, {255, 186,   0},
+    {255, 192,   0}, {255, 198,   0}, {255, 204,   0}, {255, 210,   0}, {255, 216,   0}, {255, 222,   0}, {255, 228,   0}, {255, 234,   0},
+    {255, 240,   0}, {255, 246,   0}, {255, 252,   0}, {252, 255,   0}, {246, 255,   0}, {240, 255,   0}, {234, 255,   0}, {228, 255,   0},
+    {222, 255,   0}, {216, 255,   0}, {210, 255,   0}, {204, 255,   0}, {198, 255,   0}, {192, 255,   0}, {186, 255,   0}, {180, 255,   0},
+    {174, 255,   0}, {168, 255,   0}, {162, 255,   0}, {156, 255,   0}, {150, 255,   0}, {144, 255,   0}, {138, 255,   0}, {132, 255,   0},
+    {126, 255,   0}, {120, 255,   0}, {114, 255,   0}, {108, 255,   0}, {102, 255,   0}, { 96, 255,   0}, { 90, 255,   0}, { 84, 255,   0},
+    { 78, 255,   0}, { 72, 255,   0}, { 66, 255,   0}, { 60, 255,   0}, { 54, 255,   0}, { 48, 255,   0}, { 42, 255,   0}, { 36, 255,   0},
+    { 30, 255,   0}, { 24, 255,   0}, { 18, 255,   0}, { 12, 255,   0}, {  6, 255,   0}, {  0, 255,   0}, {  0, 255,   6}, {  0, 255,  12},
+    {  0, 255,  18}, {  0, 255,  24}, {  0, 255,  30}, {  0, 255,  36}, {  0, 255,  42}, {  0, 255,  48}, {  0, 255,  54}, {  0, 255,  60},
+    {  0, 255,  66}, {  0, 255,  72}, {  0, 255,  78}, {  0, 255,  84}, {  0, 255,  90}, {  0, 255,  96}, {  0, 255, 102}, {  0, 255, 108},
+    {  0, 255, 114}, {  0, 255, 120}, {  0, 255, 126}, {  0, 255, 132}, {  0, 255, 138}, {  0, 255, 144}, {  0, 255, 150}, {  0, 255, 156},
+    {  0, 255, 162}, {  0, 255, 168}, {  0, 255, 174}, {  0, 255, 180}, {  0, 255, 186}, {  0, 255, 192}, {  0, 255, 198}, {  0, 255, 204},
+    {  0, 255, 210}, {  0, 255, 216}, {  0, 255, 222}, {  0, 255, 228}, {  0, 255, 234}, {  0, 255, 240}, {  0, 255, 246}, {  0, 255, 252},
+    {  0, 252, 255}, {  0, 246, 255}, {  0, 240, 255}, {  0, 234, 255}, {  0, 228, 255}, {  0, 222, 255}, {  0, 216, 255}, {  0, 210, 255},
+    {  0, 204, 255}, {  0, 198, 255}, {  0, 192, 255}, {  0, 186, 255}, {  0, 180, 255}, {  0, 174, 255}, {  0, 168, 255}, {  0, 162, 255},
+    {  0, 156, 255}, {  0, 150, 255}, {  0, 144, 255}, {  0, 138, 255}, {  0, 132, 255}, {  0, 126, 255}, {  0, 120, 255}, {  0, 114, 255},
+    {  0, 108, 255}, {  0, 102, 255}, {  0,  96, 255}, {  0,  90, 255}, {  0,  84, 255}, {  0,  78, 255}, {  0,  72, 255}, {  0,  66, 255},
+    {  0,  60, 255}, {  0,  54, 255}, {  0,  48, 255}, {  0,  42, 255}, {  0,  36, 255}, {  0,  30, 255}, {  0,  24, 255}, {  0,  18, 255},
+    {  0,  12, 255}, {  0,   6, 255}, {  0,   0, 255}, {  6,   0, 255}, { 12,   0, 255}, { 18,   0, 255}, { 24,   0, 255}, { 30,   0, 255},
+    { 36,   0, 255}, { 42,   0, 255}, { 48,   0, 255}, { 54,   0, 255}, { 60,   0, 255}, { 66,   0, 255}, { 72,   0, 255}, { 78,   0, 255},
+    { 84,   0, 255}, { 90,   0, 255}, { 96,   0, 255}, {102,   0, 255}, {108,   0, 255}, {114,   0, 255}, {120,   0, 255}, {126,   0, 255},
+    {132,   0, 255}, {138,   0, 255}, {144,   0, 255}, {150,   0, 255}, {156,   0, 255}, {162,   0, 255}, {168,   0, 255}, {174,   0, 255},
+    {180,   0, 255}, {186,   0, 255}, {192,   0, 255}, {198,   0, 255}, {204,   0, 255}, {210,   0, 255}, {216,   0, 255}, {222,   0, 255},
+    {228,   0, 255}, {234,   0, 255}, {240,   0, 255}, {246,   0, 255}, {252,   0, 255}, {255,   0, 252}, {255,   0, 246}, {255,   0, 240},
+    {255,   0, 234}, {255,   0, 228}, {255,   0, 222}, {255,   0, 216}, {255,   0, 210}, {255,   0, 204}, {255,   0, 198}, {255,   0, 192},
+    {255,   0, 186}, {255,   0, 180}, {255,   0, 174}, {255,   0, 168}, {255,   0, 162}, {255,   0, 156}, {255,   0, 150}, {255,   0, 144},
+    {255,   0, 138}, {255,   0, 132}, {255,   0, 126}, {255,   0, 120}, {255,   0, 114}, {255,   0, 108}, {255,   0, 102}, {255,   0,  96},
+    {255,   0,  90}, {255,   0,  84}, {255,   0,  78}, {255,   0,  72}, {255,   0,  66}, {255,   0,  60}, {255,   0,  54}, {255,   0,  48},
+    {255,   0,  42}, {255,   0,  36}, {255,   0,  30}, {255,   0,  24}, {255,   0,  18}, {255,   0,  12}, {255,   0,   6}, {255,   0,   0},
+};
+
+// distance from each key LED to every LED
+static const uint8_t led_distance[LED_TABLES_KEY_COUNT][LED_TABLES_LED_COUNT] = {
+    {
+          0,  16,  32,  48,  64,  80,  96, 112, 128, 144, 160, 176, 192, 220,  10,  26,
+         41,  56,  72,  88, 104, 120, 136, 152, 168, 184, 200, 222,  20,  34,  48,  63,
+         78,  94, 109, 125, 141, 157, 173, 189, 216,  31,  46,  59,  73,  88, 103, 118,
+        134, 150, 165, 182, 226,  40,  44,  56, 117, 180, 196, 210, 226, 231, 231, 231,
+    },
+    {
+         16,   0,  16,  32,  48,  64,  80,  96, 112, 128, 144, 160, 176, 204,  15,  12,
+         26,  41,  56,  72,  88, 104, 120, 136, 152, 168, 184, 206,  23,  23,  34,  48,
+         63,  78,  94, 109, 125, 141, 157, 173, 200,  31,  35,  46,  59,  73,  88, 103,
+        118, 134, 150, 166, 210,  43,  40,  46, 102, 164, 180, 194, 210, 216, 216, 216,
+    },
+    {
+         32,  16,   0,  16,  32,  48,  64,  80,  96, 112, 128, 144, 160, 188,  29,  12,
+         12,  26,  41,  56,  72,  88, 104, 120, 136, 152, 168, 190,  34,  20,  23,  34,
+         48,  63,  78,  94, 109, 125, 141, 157, 185,  38,  30,  35,  46,  59,  73,  88,
+        103, 118, 134, 151, 194,  51,  41,  40,  87, 149, 164, 178, 194, 200, 200, 200,
+    },
+    {
+         48,  32,  16,   0,  16,  32,  48,  64,  80,  96, 112, 128, 144, 172,  45,  26,
+         12,  12,  26,  41,  56,  72,  88, 104, 120, 136, 152, 174,  48,  28,  20,  23,
+         34,  48,  63,  78,  94, 109, 125, 141, 169,  50,  32,  30,  35,  46,  59,  73,
+         88, 103, 118, 135, 178,  62,  48,  40,  73, 134, 149, 162, 178, 185, 185, 185,
+    },
+    {
+         64,  48,  32,  16,   0,  16,  32,  48,  64,  80,  96, 112, 128, 156,  60,  41,
+         26,  12,  12,  26,  41,  56,  72,  88, 104, 120, 136, 158,  63,  41,  28,  20,
+         23,  34,  48,  63,  78,  94, 109, 125, 153,  63,  41,  32,  30,  35,  46,  59,
+         73,  88, 103, 119, 162,  75,  59,  46,  60, 118, 134, 147, 162, 170, 170, 170,
+    },
+    {
+         80,  64,  48,  32,  16,   0,  16,  32,  48,  64,  80,  96, 112, 140,  76,  56,
+         41,  26,  12,  12,  26,  41,  56,  72,  88, 104, 120, 142,  78,  55,  41,  28,
+         20,  23,  34,  48,  63,  78,  94, 109, 137,  78,  54,  41,  32,  30,  35,  46,
+         59,  73,  88, 104, 147,  89,  72,  56,  50, 104, 118, 131, 147, 155, 155, 155,
+    },
+    {
+         96,  80,  64,  48,  32,  16,   0,  16,  32,  48,  64,  80,  96, 124,  92,  72,
+         56,  41,  26,  12,  12,  26,  41,  56,  72,  88, 104, 126,  94,  70,  55,  41,
+         28,  20,  23,  34,  48,  63,  78,  94, 121,  92,  67,  54,  41,  32,  30,  35,
+         46,  59,  73,  89, 131, 104,  85,  68,  42,  89, 104, 115, 131, 140, 140, 140,
+    },
+    {
+        112,  96,  80,  64,  48,  32,  16,   0,  16,  32,  48,  64,  80, 108, 108,  88,
+         72,  56,  41,  26,  12,  12,  26,  41,  56,  72,  88, 110, 109,  86,  70,  55,
+         41,  28,  20,  23,  34,  48,  63,  78, 105, 108,  82,  67,  54,  41,  32,  30,
+         35,  46,  59,  74, 115, 118, 100,  82,  40,  75,  89, 100, 115, 125, 125, 125,
+    },
+    {
+        128, 112,  96,  80,  64,  48,  32,  16,   0,  16,  32,  48,  64,  92, 124, 104,
+         88,  72,  56,  41,  26,  12,  12,  26,  41,  56,  72,  94, 125, 101,  86,  70,
+         55,  41,  28,  20,  23,  34,  48,  63,  90, 123,  97,  82,  67,  54,  41,  32,
+         30,  35,  46,  60, 100, 134, 115,  96,  43,  62,  75,  85, 100, 111, 111, 111,
+    },
+    {
+        144, 128, 112,  96,  80,  64,  48,  32,  16,   0,  16,  32,  48,  76, 140, 120,
+        104,  88,  72,  56,  41,  26,  12,  12,  26,  41,  56,  78, 141, 117, 101,  86,
+         70,  55,  41,  28,  20,  23,  34,  48,  74, 139, 113,  97,  82,  67,  54,  41,
+         32,  30,  35,  46,  85, 149, 130, 111,  52,  51,  62,  70,  85,  97,  97,  97,
+    },
+    {
+        160, 144, 128, 112,  96,  80,  64,  48,  32,  16,   0,  16,  32,  60, 156, 136,
+        120, 104,  88,  72,  56,  41,  26,  12,  12,  26,  41,  62, 157, 133, 117, 101,
+         86,  70,  55,  41,  28,  20,  23,  34,  59, 154, 128, 113,  97,  82,  67,  54,
+         41,  32,  30,  36,  70, 164, 145, 126,  64,  43,  51,  56,  70,  85,  85,  85,
+    },
+    {
+        176, 160, 144, 128, 112,  96,  80,  64,  48,  32,  16,   0,  16,  44, 172, 152,
+        136, 120, 104,  88,  72,  56,  41,  26,  12,  12,  26,  47, 173, 149, 133, 117,
+        101,  86,  70,  55,  41,  28,  20,  23,  44, 170, 144, 128, 113,  97,  82,  67,
+         54,  41,  32,  30,  56, 180, 161, 141,  77,  40,  43,  43,  56,  73,  73,  73,
+    },
+    {
+        192, 176, 160, 144, 128, 112,  96,  80,  64,  48,  32,  16,   0,  28, 188, 168,
+        152, 136, 120, 104,  88,  72,  56,  41,  26,  12,  12,  31, 189, 165, 149, 133,
+        117, 101,  86,  70,  55,  41,  28,  20,  31, 186, 159, 144, 128, 113,  97,  82,
+         67,  54,  41,  32,  43, 196, 176, 157,  91,  43,  40,  34,  43,  64,  64,  64,
+    },
+    {
+        220, 204, 188, 172, 156, 140, 124, 108,  92,  76,  60,  44,  28,   0, 216, 196,
+        180, 164, 148, 132, 116, 100,  84,  68,  52,  37,  22,  10, 216, 193, 177, 161,
+        145, 129, 113,  98,  82,  67,  52,  37,  20, 214, 187, 171, 155, 140, 124, 109,
+         93,  78,  64,  50,  30, 223, 203, 184, 117,  59,  48,  32,  30,  55,  55,  55,
+    },
+    {
+         10,  15,  29,  45,  60,  76,  92, 108, 124, 140, 156, 172, 188, 216,   0,  20,
+         36,  52,  68,  84, 100, 116, 132, 148, 164, 180, 196, 218,  10,  26,  41,  56,
+         72,  88, 104, 120, 136, 152, 168, 184, 212,  20,  36,  51,  66,  81,  97, 112,
+        128, 144, 160, 177, 220,  30,  34,  46, 110, 174, 190, 204, 220, 225, 225, 225,
+    },
+    {
+         26,  12,  12,  26,  41,  56,  72,  88, 104, 120, 136, 152, 168, 196,  20,   0,
+         16,  32,  48,  64,  80,  96, 112, 128, 144, 160, 176, 198,  22,  10,  22,  37,
+         52,  68,  84, 100, 116, 132, 148, 164, 192,  25,  22,  33,  47,  62,  77,  93,
+        108, 124, 140, 157, 200,  38,  30,  34,  91, 154, 170, 185, 200, 205, 205, 205,
+    },
+    {
+         41,  26,  12,  12,  26,  41,  56,  72,  88, 104, 120, 136, 152, 180,  36,  16,
+          0,  16,  32,  48,  64,  80,  96, 112, 128, 144, 160, 182,  37,  15,  10,  22,
+         37,  52,  68,  84, 100, 116, 132, 148, 176,  37,  20,  22,  33,  47,  62,  77,
+         93, 108, 124, 141, 185,  50,  36,  30,  76, 139, 154, 169, 185, 190, 190, 190,
+    },
+    {
+         56,  41,  26,  12,  12,  26,  41,  56,  72,  88, 104, 120, 136, 164,  52,  32,
+         16,   0,  16,  32,  48,  64,  80,  96, 112, 128, 144, 166,  52,  29,  15,  10,
+         22,  37,  52,  68,  84, 100, 116, 132, 160,  52,  29,  20,  22,  33,  47,  62,
+         77,  93, 108, 125, 169,  63,  46,  34,  61, 123, 139, 153, 169, 174, 174, 174,
+    },
+    {
+         72,  56,  41,  26,  12,  12,  26,  41,  56,  72,  88, 104, 120, 148,  68,  48,
+         32,  16,   0,  16,  32,  48,  64,  80,  96, 112, 128, 150,  68,  45,  29,  15,
+         10,  22,  37,  52,  68,  84, 100, 116, 144,  67,  42,  29,  20,  22,  33,  47,
+         62,  77,  93, 109, 153,  78,  60,  43,  48, 108, 123, 137, 153, 159, 159, 159,
+    },
+    {
+         88,  72,  56,  41,  26,  12,  12,  26,  41,  56,  72,  88, 104, 132,  84,  64,
+         48,  32,  16,   0,  16,  32,  48,  64,  80,  96, 112, 134,  84,  60,  45,  29,
+         15,  10,  22,  37,  52,  68,  84, 100, 128,  82,  56,  42,  29,  20,  22,  33,
+         47,  62,  77,  94, 137,  92,  74,  56,  37,  92, 108, 121, 137, 144, 144, 144,
+    },
+    {
+        104,  88,  72,  56,  41,  26,  12,  12,  26,  41,  56,  72,  88, 116, 100,  80,
+         64,  48,  32,  16,   0,  16,  32,  48,  64,  80,  96, 118, 100,  76,  60,  45,
+         29,  15,  10,  22,  37,  52,  68,  84, 112,  98,  71,  56,  42,  29,  20,  22,
+         33,  47,  62,  78, 121, 108,  89,  70,  30,  78,  92, 105, 121, 129, 129, 129,
+    },
+    {
+        120, 104,  88,  72,  56,  41,  26,  12,  12,  26,  41,  56,  72, 100, 116,  96,
+         80,  64,  48,  32,  16,   0,  16,  32,  48,  64,  80, 102, 116,  92,  76,  60,
+         45,  29,  15,  10,  22,  37,  52,  68,  96, 113,  87,  71,  56,  42,  29,  20,
+         22,  33,  47,  63, 105, 123, 104,  85,  31,  63,  78,  90, 105, 114, 114, 114,
+    },
+    {
+        136, 120, 104,  88,  72,  56,  41,  26,  12,  12,  26,  41,  56,  84, 132, 112,
+         96,  80,  64,  48,  32,  16,   0,  16,  32,  48,  64,  86, 132, 108,  92,  76,
+         60,  45,  29,  15,  10,  22,  37,  52,  80, 129, 102,  87,  71,  56,  42,  29,
+         20,  22,  33,  48,  90, 139, 119, 100,  39,  50,  63,  74,  90,  99,  99,  99,
+    },
+    {
+        152, 136, 120, 104,  88,  72,  56,  41,  26,  12,  12,  26,  41,  68, 148, 128,
+        112,  96,  80,  64,  48,  32,  16,   0,  16,  32,  48,  70, 148, 124, 108,  92,
+         76,  60,  45,  29,  15,  10,  22,  37,  64, 145, 118, 102,  87,  71,  56,  42,
+         29,  20,  22,  34,  74, 154, 135, 115,  51,  38,  50,  59,  74,  85,  85,  85,
+    },
+    {
+        168, 152, 136, 120, 104,  88,  72,  56,  41,  26,  12,  12,  26,  52, 164, 144,
+        128, 112,  96,  80,  64,  48,  32,  16,   0,  16,  32,  54, 164, 140, 124, 108,
+         92,  76,  60,  45,  29,  15,  10,  22,  49, 161, 134, 118, 102,  87,  71,  56,
+         42,  29,  20,  23,  59, 170, 151, 131,  65,  31,  38,  44,  59,  72,  72,  72,
+    },
+    {
+        184, 168, 152, 136, 120, 104,  88,  72,  56,  41,  26,  12,  12,  37, 180, 160,
+        144, 128, 112,  96,  80,  64,  48,  32,  16,   0,  16,  38, 180, 156, 140, 124,
+        108,  92,  76,  60,  45,  29,  15,  10,  33, 177, 150, 134, 118, 102,  87,  71,
+         56,  42,  29,  20,  44, 186, 166, 147,  79,  31,  31,  31,  44,  60,  60,  60,
+    },
+    {
+        200, 184, 168, 152, 136, 120, 104,  88,  72,  56,  41,  26,  12,  22, 196, 176,
+        160, 144, 128, 112,  96,  80,  64,  48,  32,  16,   0,  22, 196, 172, 156, 140,
+        124, 108,  92,  76,  60,  45,  29,  15,  18, 193, 166, 150, 134, 118, 102,  87,
+         71,  56,  42,  28,  31, 202, 182, 162,  94,  38,  31,  21,  31,  51,  51,  51,
+    },
+    {
+        222, 206, 190, 174, 158, 142, 126, 110,  94,  78,  62,  47,  31,  10, 218, 198,
+        182, 166, 150, 134, 118, 102,  86,  70,  54,  38,  22,   0, 218, 194, 178, 162,
+        146, 130, 114,  98,  82,  66,  50,  35,  11, 214, 188, 172, 156, 140, 124, 108,
+         93,  77,  62,  46,  20, 224, 204, 184, 115,  54,  42,  24,  20,  45,  45,  45,
+    },
+    {
+         20,  23,  34,  48,  63,  78,  94, 109, 125, 141, 157, 173, 189, 216,  10,  22,
+         37,  52,  68,  84, 100, 116, 132, 148, 164, 180, 196, 218,   0,  24,  40,  56,
+         72,  88, 104, 120, 136, 152, 168, 184, 212,  10,  32,  48,  63,  79,  95, 111,
+        127, 143, 159, 176, 220,  20,  25,  41, 107, 173, 189, 204, 220, 223, 223, 223,
+    },
+    {
+         34,  23,  20,  28,  41,  55,  70,  86, 101, 117, 133, 149, 165, 193,  26,  10,
+         15,  29,  45,  60,  76,  92, 108, 124, 140, 156, 172, 194,  24,   0,  16,  32,
+         48,  64,  80,  96, 112, 128, 144, 160, 188,  22,  12,  25,  40,  55,  71,  87,
+        103, 119, 135, 152, 196,  34,  21,  23,  84, 149, 165, 180, 196, 200, 200, 200,
+    },
+    {
+         48,  34,  23,  20,  28,  41,  55,  70,  86, 101, 117, 133, 149, 177,  41,  22,
+         10,  15,  29,  45,  60,  76,  92, 108, 124, 140, 156, 178,  40,  16,   0,  16,
+         32,  48,  64,  80,  96, 112, 128, 144, 172,  37,  13,  12,  25,  40,  55,  71,
+         87, 103, 119, 136, 180,  48,  31,  20,  68, 133, 149, 164, 180, 184, 184, 184,
+    },
+    {
+         63,  48,  34,  23,  20,  28,  41,  55,  70,  86, 101, 117, 133, 161,  56,  37,
+         22,  10,  15,  29,  45,  60,  76,  92, 108, 124, 140, 162,  56,  32,  16,   0,
+         16,  32,  48,  64,  80,  96, 112, 128, 156,  52,  26,  13,  12,  25,  40,  55,
+         71,  87, 103, 120, 164,  63,  44,  28,  53, 117, 133, 148, 164, 168, 168, 168,
+    },
+    {
+         78,  63,  48,  34,  23,  20,  28,  41,  55,  70,  86, 101, 117, 145,  72,  52,
+         37,  22,  10,  15,  29,  45,  60,  76,  92, 108, 124, 146,  72,  48,  32,  16,
+          0,  16,  32,  48,  64,  80,  96, 112, 140,  68,  42,  26,  13,  12,  25,  40,
+         55,  71,  87, 104, 148,  78,  59,  41,  39, 101, 117, 132, 148, 153, 153, 153,
+    },
+    {
+         94,  78,  63,  48,  34,  23,  20,  28,  41,  55,  70,  86, 101, 129,  88,  68,
+         52,  37,  22,  10,  15,  29,  45,  60,  76,  92, 108, 130,  88,  64,  48,  32,
+         16,   0,  16,  32,  48,  64,  80,  96, 124,  84,  57,  42,  26,  13,  12,  25,
+         40,  55,  71,  88, 132,  94,  74,  55,  26,  86, 101, 116, 132, 137, 137, 137,
+    },
+    {
+        109,  94,  78,  63,  48,  34,  23,  20,  28,  41,  55,  70,  86, 113, 104,  84,
+         68,  52,  37,  22,  10,  15,  29,  45,  60,  76,  92, 114, 104,  80,  64,  48,
+         32,  16,   0,  16,  32,  48,  64,  80, 108, 100,  73,  57,  42,  26,  13,  12,
+         25,  40,  55,  72, 116, 109,  90,  70,  20,  70,  86, 100, 116, 122, 122, 122,
+    },
+    {
+        125, 109,  94,  78,  63,  48,  34,  23,  20,  28,  41,  55,  70,  98, 120, 100,
+         84,  68,  52,  37,  22,  10,  15,  29,  45,  60,  76,  98, 120,  96,  80,  64,
+         48,  32,  16,   0,  16,  32,  48,  64,  92, 116,  89,  73,  57,  42,  26,  13,
+         12,  25,  40,  56, 100, 125, 105,  86,  24,  55,  70,  84, 100, 106, 106, 106,
+    },
+    {
+        141, 125, 109,  94,  78,  63,  48,  34,  23,  20,  28,  41,  55,  82, 136, 116,
+        100,  84,  68,  52,  37,  22,  10,  15,  29,  45,  60,  82, 136, 112,  96,  80,
+         64,  48,  32,  16,   0,  16,  32,  48,  76, 132, 105,  89,  73,  57,  42,  26,
+         13,  12,  25,  41,  84, 141, 121, 101,  36,  41,  55,  68,  84,  91,  91,  91,
+    },
+    {
+        157, 141, 125, 109,  94,  78,  63,  48,  34,  23,  20,  28,  41,  67, 152, 132,
+        116, 100,  84,  68,  52,  37,  22,  10,  15,  29,  45,  66, 152, 128, 112,  96,
+         80,  64,  48,  32,  16,   0,  16,  32,  60, 148, 121, 105,  89,  73,  57,  42,
+         26,  13,  12,  26,  68, 157, 137, 117,  50,  28,  41,  52,  68,  77,  77,  77,
+    },
+    {
+        173, 157, 141, 125, 109,  94,  78,  63,  48,  34,  23,  20,  28,  52, 168, 148,
+        132, 116, 100,  84,  68,  52,  37,  22,  10,  15,  29,  50, 168, 144, 128, 112,
+         96,  80,  64,  48,  32,  16,   0,  16,  44, 164, 137, 121, 105,  89,  73,  57,
+         42,  26,  13,  12,  52, 173, 153, 133,  65,  20,  28,  37,  52,  63,  63,  63,
+    },
+    {
+        189, 173, 157, 141, 125, 109,  94,  78,  63,  48,  34,  23,  20,  37, 184, 164,
+        148, 132, 116, 100,  84,  68,  52,  37,  22,  10,  15,  35, 184, 160, 144, 128,
+        112,  96,  80,  64,  48,  32,  16,   0,  28, 180, 153, 137, 121, 105,  89,  73,
+         57,  42,  26,  12,  37, 189, 169, 149,  80,  23,  20,  22,  37,  50,  50,  50,
+    },
+    {
+        216, 200, 185, 169, 153, 137, 121, 105,  90,  74,  59,  44,  31,  20, 212, 192,
+        176, 160, 144, 128, 112,  96,  80,  64,  49,  33,  18,  11, 212, 188, 172, 156,
+        140, 124, 108,  92,  76,  60,  44,  28,   0, 208, 181, 165, 149, 133, 117, 101,
+         85,  69,  53,  37,  12, 216, 197, 177, 107,  44,  31,  12,  12,  36,  36,  36,
+    },
+    {
+         31,  31,  38,  50,  63,  78,  92, 108, 123, 139, 154, 170, 186, 214,  20,  25,
+         37,  52,  67,  82,  98, 113, 129, 145, 161, 177, 193, 214,  10,  22,  37,  52,
+         68,  84, 100, 116, 132, 148, 164, 180, 208,   0,  27,  43,  59,  75,  91, 107,
+        123, 139, 155, 172, 216,  12,  15,  33, 102, 168, 184, 200, 216, 218, 218, 218,
+    },
+    {
+         46,  35,  30,  32,  41,  54,  67,  82,  97, 113, 128, 144, 159, 187,  36,  22,
+         20,  29,  42,  56,  71,  87, 102, 118, 134, 150, 166, 188,  32,  12,  13,  26,
+         42,  57,  73,  89, 105, 121, 137, 153, 181,  27,   0,  16,  32,  48,  64,  80,
+         96, 112, 128, 145, 189,  36,  18,  11,  75, 141, 157, 173, 189, 191, 191, 191,
+    },
+    {
+         59,  46,  35,  30,  32,  41,  54,  67,  82,  97, 113, 128, 144, 171,  51,  33,
+         22,  20,  29,  42,  56,  71,  87, 102, 118, 134, 150, 172,  48,  25,  12,  13,
+         26,  42,  57,  73,  89, 105, 121, 137, 165,  43,  16,   0,  16,  32,  48,  64,
+         80,  96, 112, 129, 173,  51,  32,  14,  59, 125, 141, 157, 173, 175, 175, 175,
+    },
+    {
+         73,  59,  46,  35,  30,  32,  41,  54,  67,  82,  97, 113, 128, 155,  66,  47,
+         33,  22,  20,  29,  42,  56,  71,  87, 102, 118, 134, 156,  63,  40,  25,  12,
+         13,  26,  42,  57,  73,  89, 105, 121, 149,  59,  32,  16,   0,  16,  32,  48,
+         64,  80,  96, 113, 157,  67,  48,  28,  44, 109, 125, 141, 157, 159, 159, 159,
+    },
+    {
+         88,  73,  59,  46,  35,  30,  32,  41,  54,  67,  82,  97, 113, 140,  81,  62,
+         47,  33,  22,  20,  29,  42,  56,  71,  87, 102, 118, 140,  79,  55,  40,  25,
+         12,  13,  26,  42,  57,  73,  89, 105, 133,  75,  48,  32,  16,   0,  16,  32,
+         48,  64,  80,  97, 141,  83,  63,  44,  28,  93, 109, 125, 141, 144, 144, 144,
+    },
+    {
+        103,  88,  73,  59,  46,  35,  30,  32,  41,  54,  67,  82,  97, 124,  97,  77,
+         62,  47,  33,  22,  20,  29,  42,  56,  71,  87, 102, 124,  95,  71,  55,  40,
+         25,  12,  13,  26,  42,  57,  73,  89, 117,  91,  64,  48,  32,  16,   0,  16,
+         32,  48,  64,  81, 125,  99,  79,  59,  14,  77,  93, 109, 125, 128, 128, 128,
+    },
+    {
+        118, 103,  88,  73,  59,  46,  35,  30,  32,  41,  54,  67,  82, 109, 112,  93,
+         77,  62,  47,  33,  22,  20,  29,  42,  56,  71,  87, 108, 111,  87,  71,  55,
+         40,  25,  12,  13,  26,  42,  57,  73, 101, 107,  80,  64,  48,  32,  16,   0,
+         16,  32,  48,  65, 109, 115,  95,  75,  11,  61,  77,  93, 109, 112, 112, 112,
+    },
+    {
+        134, 118, 103,  88,  73,  59,  46,  35,  30,  32,  41,  54,  67,  93, 128, 108,
+         93,  77,  62,  47,  33,  22,  20,  29,  42,  56,  71,  93, 127, 103,  87,  71,
+         55,  40,  25,  12,  13,  26,  42,  57,  85, 123,  96,  80,  64,  48,  32,  16,
+          0,  16,  32,  49,  93, 131, 111,  91,  23,  46,  61,  77,  93,  97,  97,  97,
+    },
+    {
+        150, 134, 118, 103,  88,  73,  59,  46,  35,  30,  32,  41,  54,  78, 144, 124,
+        108,  93,  77,  62,  47,  33,  22,  20,  29,  42,  56,  77, 143, 119, 103,  87,
+         71,  55,  40,  25,  12,  13,  26,  42,  69, 139, 112,  96,  80,  64,  48,  32,
+         16,   0,  16,  33,  77, 147, 127, 107,  38,  30,  46,  61,  77,  81,  81,  81,
+    },
+    {
+        165, 150, 134, 118, 103,  88,  73,  59,  46,  35,  30,  32,  41,  64, 160, 140,
+        124, 108,  93,  77,  62,  47,  33,  22,  20,  29,  42,  62, 159, 135, 119, 103,
+         87,  71,  55,  40,  25,  12,  13,  26,  53, 155, 128, 112,  96,  80,  64,  48,
+         32,  16,   0,  17,  61, 163, 143, 123,  53,  16,  30,  45,  61,  66,  66,  66,
+    },
+    {
+        182, 166, 151, 135, 119, 104,  89,  74,  60,  46,  36,  30,  32,  50, 177, 157,
+        141, 125, 109,  94,  78,  63,  48,  34,  23,  20,  28,  46, 176, 152, 136, 120,
+        104,  88,  72,  56,  41,  26,  12,  12,  37, 172, 145, 129, 113,  97,  81,  65,
+         49,  33,  17,   0,  44, 180, 160, 140,  70,  10,  15,  28,  44,  51,  51,  51,
+    },
+    {
+        226, 210, 194, 178, 162, 147, 131, 115, 100,  85,  70,  56,  43,  30, 220, 200,
+        185, 169, 153, 137, 121, 105,  90,  74,  59,  44,  31,  20, 220, 196, 180, 164,
+        148, 132, 116, 100,  84,  68,  52,  37,  12, 216, 189, 173, 157, 141, 125, 109,
+         93,  77,  61,  44,   0, 224, 204, 184, 114,  49,  33,  16,   0,  25,  25,  25,
+    },
+    {
+         40,  43,  51,  62,  75,  89, 104, 118, 134, 149, 164, 180, 196, 223,  30,  38,
+         50,  63,  78,  92, 108, 123, 139, 154, 170, 186, 202, 224,  20,  34,  48,  63,
+         78,  94, 109, 125, 141, 157, 173, 189, 216,  12,  36,  51,  67,  83,  99, 115,
+        131, 147, 163, 180, 224,   0,  20,  40, 110, 176, 192, 208, 224, 225, 225, 225,
+    },
+    {
+         44,  40,  41,  48,  59,  72,  85, 100, 115, 130, 145, 161, 176, 203,  34,  30,
+         36,  46,  60,  74,  89, 104, 119, 135, 151, 166, 182, 204,  25,  21,  31,  44,
+         59,  74,  90, 105, 121, 137, 153, 169, 197,  15,  18,  32,  48,  63,  79,  95,
+        111, 127, 143, 160, 204,  20,   0,  20,  90, 156, 172, 188, 204, 205, 205, 205,
+    },
+    {
+         56,  46,  40,  40,  46,  56,  68,  82,  96, 111, 126, 141, 157, 184,  46,  34,
+         30,  34,  43,  56,  70,  85, 100, 115, 131, 147, 162, 184,  41,  23,  20,  28,
+         41,  55,  70,  86, 101, 117, 133, 149, 177,  33,  11,  14,  28,  44,  59,  75,
+         91, 107, 123, 140, 184,  40,  20,   0,  70, 136, 152, 168, 184, 185, 185, 185,
+    },
+    {
+        117, 102,  87,  73,  60,  50,  42,  40,  43,  52,  64,  77,  91, 117, 110,  91,
+         76,  61,  48,  37,  30,  31,  39,  51,  65,  79,  94, 115, 107,  84,  68,  53,
+         39,  26,  20,  24,  36,  50,  65,  80, 107, 102,  75,  59,  44,  28,  14,  11,
+         23,  38,  53,  70, 114, 110,  90,  70,   0,  66,  82,  98, 114, 115, 115, 115,
+    },
+    {
+        180, 164, 149, 134, 118, 104,  89,  75,  62,  51,  43,  40,  43,  59, 174, 154,
+        139, 123, 108,  92,  78,  63,  50,  38,  31,  31,  38,  54, 173, 149, 133, 117,
+        101,  86,  70,  55,  41,  28,  20,  23,  44, 168, 141, 125, 109,  93,  77,  61,
+         46,  30,  16,  10,  49, 176, 156, 136,  66,   0,  16,  33,  49,  51,  51,  51,
+    },
+    {
+        196, 180, 164, 149, 134, 118, 104,  89,  75,  62,  51,  43,  40,  48, 190, 170,
+        154, 139, 123, 108,  92,  78,  63,  50,  38,  31,  31,  42, 189, 165, 149, 133,
+        117, 101,  86,  70,  55,  41,  28,  20,  31, 184, 157, 141, 125, 109,  93,  77,
+         61,  46,  30,  15,  33, 192, 172, 152,  82,  16,   0,  18,  33,  36,  36,  36,
+    },
+    {
+        210, 194, 178, 162, 147, 131, 115, 100,  85,  70,  56,  43,  34,  32, 204, 185,
+        169, 153, 137, 121, 105,  90,  74,  59,  44,  31,  21,  24, 204, 180, 164, 148,
+        132, 116, 100,  84,  68,  52,  37,  22,  12, 200, 173, 157, 141, 125, 109,  93,
+         77,  61,  45,  28,  16, 208, 188, 168,  98,  33,  18,   0,  16,  30,  30,  30,
+    },
+    {
+        226, 210, 194, 178, 162, 147, 131, 115, 100,  85,  70,  56,  43,  30, 220, 200,
+        185, 169, 153, 137, 121, 105,  90,  74,  59,  44,  31,  20, 220, 196, 180, 164,
+        148, 132, 116, 100,  84,  68,  52,  37,  12, 216, 189, 173, 157, 141, 125, 109,
+         93,  77,  61,  44,   0, 224, 204, 184, 114,  49,  33,  16,   0,  25,  25,  25,
+    },
+};
@@ -0,0 +1,162 @@
+#include "quantum.h"
+#include "matrix.h"
+#include "matrix_idle.h"
+#include "qk61_trace.h"
+#include "boot_profile.h"
+
+// ROW2COL matrix with an idle mode.
+//
+// Columns are driven low one at a time and the rows are read, like the
+// stock QMK matrix. After MATRIX_IDLE_TIME ms with no key down all
+// columns are driven low together, so any key press pulls its row low:
+// an idle scan is then a single read of the six row pins, and the row
+// pins raise a falling edge event that can wake a sleeping main loop.
+// The first active row ends idle mode and the full scan runs in the same
+// call, so a wake costs no extra scan period.
+
+#ifndef MATRIX_IDLE_TIME
+#    define MATRIX_IDLE_TIME 50
+#endif
+
+static const pin_t row_pins[MATRIX_ROWS] = MATRIX_ROW_PINS;
+static const pin_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
+
+static bool          matrix_idle = false;
+static uint16_t      last_activity;
+static volatile bool wake_event  = false;
+#if PAL_USE_CALLBACKS
+static binary_semaphore_t wake_sem;
+#endif
+
+static inline void select_col(uint8_t col) {
+    setPinOutput(col_pins[col]);
+    writePinLow(col_pins[col]);
+}
+
+static inline void unselect_col(uint8_t col) {
+#ifdef MATRIX_UNSELECT_DRIVE_HIGH
+    setPinOutput(col_pins[col]);
+    writePinHigh(col_pins[col]);
+#else
+    setPinInputHigh(col_pins[col]);
+#endif
+}
+
+static inline bool any_row_active(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (readPin(row_pins[row]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if PAL_USE_CALLBACKS
+static void row_wake_cb(void *arg) {
+    (void)arg;
+    wake_event = true;
+    chSysLockFromISR();
+    chBSemSignalI(&wake_sem);
+    chSysUnlockFromISR();
+}
+#endif
+
+static void matrix_enter_idle(void) {
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        select_col(col);
+    }
+    wake_event = false;
+#if PAL_USE_CALLBACKS
+    chBSemReset(&wake_sem, true);
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        palSetLineCallback(row_pins[row], row_wake_cb, NULL);
+        palEnableLineEvent(row_pins[row], PAL_EVENT_MODE_FALLING_EDGE);
+    }
+#endif
+    matrix_idle = true;
+}
+
+static void matrix_leave_idle(void) {
+#if PAL_USE_CALLBACKS
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        palDisableLineEvent(row_pins[row]);
+    }
+#endif
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        unselect_col(col);
+    }
+    matrix_output_unselect_delay(MATRIX_COLS - 1, true);
+    matrix_idle   = false;
+    last_activity = timer_read();
+    boot_profile_wake();
+}
+
+bool matrix_is_idle(void) {
+    return matrix_idle;
+}
+
+void matrix_idle_wait(uint32_t timeout_ms) {
+    if (!matrix_idle || wake_event || any_row_active()) {
+        return;
+    }
+#if PAL_USE_CALLBACKS
+    chBSemWaitTimeout(&wake_sem, TIME_MS2I(timeout_ms));
+#else
+    chThdSleepMilliseconds(timeout_ms);
+#endif
+}
+
+void matrix_init_custom(void) {
+#if PAL_USE_CALLBACKS
+    chBSemObjectInit(&wake_sem, true);
+#endif
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        setPinInputHigh(row_pins[row]);
+    }
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        unselect_col(col);
+    }
+    last_activity = timer_read();
+}
+
+bool matrix_scan_custom(matrix_row_t current_matrix[]) {
+    if (matrix_idle) {
+        // the edge event can be lost while arming, the level read cannot
+        if (!wake_event && !any_row_active()) {
+            return false;
+        }
+        matrix_leave_idle();
+    }
+
+    matrix_row_t next_matrix[MATRIX_ROWS] = {0};
+    bool         any_pressed              = false;
+
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        bool key_pressed = false;
+
+        select_col(col);
+        matrix_output_select_delay();
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            if (readPin(row_pins[row]) == 0) {
+                next_matrix[row] |= (MATRIX_ROW_SHIFTER << col);
+                key_pressed = true;
+            }
+        }
+        unselect_col(col);
+        matrix_output_unselect_delay(col, key_pressed);
+        any_pressed |= key_pressed;
+    }
+
+    bool changed = memcmp(current_matrix, next_matrix, sizeof(next_matrix)) != 0;
+    if (changed) {
+        memcpy(current_matrix, next_matrix, sizeof(next_matrix));
+        trace_matrix_changed();
+    }
+
+    if (any_pressed) {
+        last_activity = timer_read();
+    } else if (timer_elapsed(last_activity) > MATRIX_IDLE_TIME) {
+        matrix_enter_idle();
+    }
+    return changed;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// true while matrix.c waits for a key with all columns driven
+bool matrix_is_idle(void);
+
+// sleeps the calling thread until a row edge or timeout_ms, returns at
+// once unless idle
+void matrix_idle_wait(uint32_t timeout_ms);
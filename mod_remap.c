@@ -0,0 +1,120 @@
+#include "quantum.h"
+#include "mod_remap.h"
+
+// optional, both absent when a keymap has no tap dance overrides
+extern const uint16_t lalt_td_overrides[] __attribute__((weak));
+extern const uint8_t  lalt_td_overrides_count __attribute__((weak));
+
+static bool     latched;   // LAlt is down
+static bool     committed; // and the real Alt has been sent
+static bool     used;      // a key was pressed under it
+static uint16_t latch_time;
+
+static struct {
+    keypos_t key;
+    uint16_t keycode; // replacement sent, KC_NO when free
+} held[MOD_REMAP_HELD_MAX];
+
+static uint16_t lalt_override(uint16_t keycode) {
+    if (IS_QK_TAP_DANCE(keycode)) {
+        uint8_t index = QK_TAP_DANCE_GET_INDEX(keycode);
+
+        return &lalt_td_overrides_count && index < lalt_td_overrides_count ? pgm_read_word(&lalt_td_overrides[index]) : KC_NO;
+    }
+    if (IS_QK_LAYER_TAP(keycode)) {
+        keycode = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+    } else if (IS_QK_MOD_TAP(keycode)) {
+        keycode = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+    } else if (keycode == QK_GRAVE_ESCAPE) {
+        keycode = KC_ESC;
+    }
+    return keycode < lalt_overrides_count ? pgm_read_word(&lalt_overrides[keycode]) : KC_NO;
+}
+
+static bool keeps_alt(uint16_t replacement) {
+    return IS_QK_MODS(replacement) && (QK_MODS_GET_MODS(replacement) & MOD_RALT) == MOD_LALT;
+}
+
+static void lalt_commit(void) {
+    if (!committed) {
+        register_code(KC_LALT);
+        committed = true;
+    }
+}
+
+static bool remap_press(keypos_t key, uint16_t replacement) {
+    for (uint8_t i = 0; i < MOD_REMAP_HELD_MAX; i++) {
+        if (held[i].keycode != KC_NO) {
+            continue;
+        }
+        // Alt stays down for the rest of the hold, Alt+Tab needs that
+        if (keeps_alt(replacement)) {
+            lalt_commit();
+            replacement &= ~QK_LALT;
+        }
+        register_code16(replacement);
+        held[i].key     = key;
+        held[i].keycode = replacement;
+        return true;
+    }
+    return false;
+}
+
+static bool remap_release(keypos_t key) {
+    for (uint8_t i = 0; i < MOD_REMAP_HELD_MAX; i++) {
+        if (held[i].keycode != KC_NO && held[i].key.row == key.row && held[i].key.col == key.col) {
+            unregister_code16(held[i].keycode);
+            held[i].keycode = KC_NO;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool process_mod_remap(uint16_t keycode, keyrecord_t *record) {
+    if (keycode == KC_LALT) {
+        if (record->event.pressed) {
+            latched    = true;
+            committed  = false;
+            used       = false;
+            latch_time = timer_read();
+        } else {
+            if (committed) {
+                unregister_code(KC_LALT);
+            } else if (!used) {
+                tap_code(KC_LALT);
+            }
+            latched = false;
+        }
+        return false;
+    }
+
+    if (!record->event.pressed) {
+        return !remap_release(record->event.key);
+    }
+    // Shift and the other mods combine with the replacement
+    if (!latched || IS_MODIFIER_KEYCODE(keycode)) {
+        return true;
+    }
+
+    uint16_t replacement = lalt_override(keycode);
+
+    // Alt went out alone for the mouse, the override replaces it
+    if (replacement != KC_NO && committed && !used && !keeps_alt(replacement)) {
+        unregister_code(KC_LALT);
+        committed = false;
+    }
+    used = true;
+    if (replacement != KC_NO && remap_press(record->event.key, replacement)) {
+        return false;
+    }
+    lalt_commit();
+    return true;
+}
+
+// a hold with no key under it is Alt for a mouse click or drag
+void mod_remap_task(void) {
+    if (latched && !committed && !used && timer_elapsed(latch_time) >= MOD_REMAP_ALT_HOLD) {
+        lalt_commit();
+    }
+}
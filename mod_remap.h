@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "quantum.h"
+
+// Left Alt remapping without a layer or a tap dance.
+//
+// A press of KC_LALT is latched, not sent. A key pressed while it is
+// latched is looked up in the keymap's override tables, indexed by
+// keycode: a hit sends the replacement instead of Alt + key, so LAlt+C
+// becomes Ctrl+C. A replacement with LALT registers the real Alt first
+// and keeps it down until LAlt is released, for Alt+Tab. Any other
+// non-modifier key sends the real Alt ahead of itself, and LAlt released
+// alone is tapped on release, so there is never a TAPPING_TERM wait.
+//
+// A click or drag on the mouse never reaches the keyboard, so LAlt held
+// with no other key sends the real Alt after MOD_REMAP_ALT_HOLD ms for
+// Alt+click and Alt+drag. An override pressed after that still applies:
+// the real Alt is lifted before the replacement, unless it carries LALT.
+//
+// Each keymap declares its overrides: lalt_overrides[] by basic keycode
+// (the tap keycode of LT and MT keys, KC_ESC for QK_GESC),
+// lalt_td_overrides[] by tap dance index, KC_NO for none. A keymap
+// without tap dance overrides leaves lalt_td_overrides and its count out.
+//
+//     const uint16_t PROGMEM lalt_overrides[] = {
+//         [KC_C] = C(KC_C),
+//     };
+//     const uint8_t lalt_overrides_count = ARRAY_SIZE(lalt_overrides);
+//
+// Built with MOD_REMAP_ENABLE = yes in the keymap rules.mk.
+
+// overridden keys down at the same time
+#ifndef MOD_REMAP_HELD_MAX
+#    define MOD_REMAP_HELD_MAX 4
+#endif
+// LAlt held alone this long goes out as the real Alt, for the mouse
+#ifndef MOD_REMAP_ALT_HOLD
+#    define MOD_REMAP_ALT_HOLD 200
+#endif
+
+extern const uint16_t lalt_overrides[];
+extern const uint8_t  lalt_overrides_count;
+extern const uint16_t lalt_td_overrides[];
+extern const uint8_t  lalt_td_overrides_count;
+
+bool process_mod_remap(uint16_t keycode, keyrecord_t *record);
+void mod_remap_task(void);
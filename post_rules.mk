@@ -0,0 +1,21 @@
+# keymap rules.mk is read after rules.mk, options a keymap may set go here
+
+# chords by matrix position, see chord.h
+ifeq ($(strip $(CHORD_ENABLE)), yes)
+    OPT_DEFS += -DCHORD_ENABLE
+    SRC += chord.c
+endif
+
+# left Alt overrides, see mod_remap.h
+ifeq ($(strip $(MOD_REMAP_ENABLE)), yes)
+    OPT_DEFS += -DMOD_REMAP_ENABLE
+    SRC += mod_remap.c
+endif
+
+# wear-levelled EEPROM log, see eeprom_log.h; it stands in for the vendor
+# FEE driver, which stays in the link unreferenced
+ifeq ($(strip $(EEPROM_LOG_ENABLE)), yes)
+    OPT_DEFS += -DEEPROM_LOG_ENABLE
+    SRC += eeprom_log.c
+    EXTRALDFLAGS += -Wl,--wrap=eeprom_driver_init -Wl,--wrap=eeprom_driver_erase -Wl,--wrap=eeprom_read_block -Wl,--wrap=eeprom_write_block
+endif
@@ -0,0 +1,109 @@
+#include "quantum.h"
+#include "../../lib/rdr_lib/rdr_common.h"
+#include "power_state.h"
+#include "user_config.h"
+#include "matrix_idle.h"
+#include "eeprom_log.h"
+
+static power_state_t state = POWER_ACTIVE;
+static uint8_t       saved_val;
+static bool          rgb_was_enabled;
+
+static uint32_t timeout(uint8_t value, uint32_t fallback, uint32_t unit) {
+    return (value ? value : fallback) * unit;
+}
+
+static power_state_t target_state(void) {
+    uint32_t quiet    = last_input_activity_elapsed();
+    bool     wireless = Keyboard_Info.Key_Mode != QMK_USB_MODE;
+
+    if (wireless && quiet > timeout(user_config.power_deep, POWER_DEEP_TIMEOUT, 60000)) {
+        return POWER_DEEP;
+    }
+    if (wireless && quiet > timeout(user_config.power_idle, POWER_IDLE_TIMEOUT, 1000)) {
+        return POWER_IDLE;
+    }
+    if (quiet > timeout(user_config.power_dim, POWER_DIM_TIMEOUT, 1000)) {
+        return POWER_DIMMED;
+    }
+    return POWER_ACTIVE;
+}
+
+// brightness and RGB state are changed without EEPROM writes and put back on wake
+static void enter_state(power_state_t next) {
+    if (state == POWER_ACTIVE) {
+        saved_val = rgb_matrix_get_val();
+        rgb_matrix_sethsv_noeeprom(rgb_matrix_get_hue(), rgb_matrix_get_sat(), saved_val / POWER_DIM_DIVISOR);
+    }
+    if (next == POWER_DEEP) {
+        rgb_was_enabled = rgb_matrix_is_enabled();
+        rgb_matrix_disable_noeeprom();
+        eeprom_log_flush();
+    } else if (state == POWER_DEEP && rgb_was_enabled) {
+        rgb_matrix_enable_noeeprom();
+    }
+    // a brightness set through VIA or a key while dimmed is kept
+    if (next == POWER_ACTIVE && rgb_matrix_get_val() == saved_val / POWER_DIM_DIVISOR) {
+        rgb_matrix_sethsv_noeeprom(rgb_matrix_get_hue(), rgb_matrix_get_sat(), saved_val);
+    }
+    state = next;
+}
+
+void power_task(void) {
+    power_state_t next = target_state();
+
+    if (next != state) {
+        enter_state(next);
+    }
+
+    if (state == POWER_IDLE) {
+        matrix_idle_wait(POWER_IDLE_WAIT);
+    } else if (state == POWER_DEEP) {
+        matrix_idle_wait(POWER_DEEP_WAIT);
+    }
+}
+
+power_state_t power_get_state(void) {
+    return state;
+}
+
+static uint8_t *power_value(uint8_t value_id) {
+    switch (value_id) {
+        case id_power_dim_timeout:
+            return &user_config.power_dim;
+        case id_power_idle_timeout:
+            return &user_config.power_idle;
+        case id_power_deep_timeout:
+            return &user_config.power_deep;
+        default:
+            return NULL;
+    }
+}
+
+bool power_via_get_value(uint8_t value_id, uint8_t *value_data) {
+    uint8_t *value = power_value(value_id);
+
+    if (!value) {
+        return false;
+    }
+    value_data[0] = *value;
+    return true;
+}
+
+bool power_via_set_value(uint8_t value_id, uint8_t *value_data) {
+    uint8_t *value = power_value(value_id);
+
+    if (!value) {
+        return false;
+    }
+    *value = value_data[0];
+    return true;
+}
+
+bool power_via_save(uint8_t value_id) {
+    if (!power_value(value_id)) {
+        return false;
+    }
+    user_config_save();
+    return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "quantum.h"
+
+// Power states stepped through by time since the last input.
+//
+//   active  full brightness, the main loop runs free
+//   dimmed  RGB brightness divided by POWER_DIM_DIVISOR
+//   idle    dimmed, the main loop sleeps in the idle matrix wait
+//   deep    RGB off, EEPROM flushed, longer matrix wait
+//
+// A key press wakes the matrix wait at once and returns to active. Idle
+// and deep are only entered in the wireless modes. Over USB the host
+// decides when the keyboard suspends. The three timeouts are stored in
+// user_config and set from VIA, 0 means the default.
+//
+// The waits are one tick by default. rdr_lib keeps the radio link and
+// reads the battery from the main loop (es_chibios_user_idle_loop_hook
+// and the vendor tasks) and does not say how often it must run, so a
+// pass is never skipped for longer than the stock loop would take; the
+// MCU still sleeps in WFI for the rest of each tick. Longer waits save
+// more but are only safe once the link is seen to survive them.
+
+typedef enum {
+    POWER_ACTIVE,
+    POWER_DIMMED,
+    POWER_IDLE,
+    POWER_DEEP,
+} power_state_t;
+
+#ifndef POWER_DIM_TIMEOUT
+#    define POWER_DIM_TIMEOUT 30 // s
+#endif
+#ifndef POWER_IDLE_TIMEOUT
+#    define POWER_IDLE_TIMEOUT 60 // s
+#endif
+#ifndef POWER_DEEP_TIMEOUT
+#    define POWER_DEEP_TIMEOUT 10 // min
+#endif
+#ifndef POWER_DIM_DIVISOR
+#    define POWER_DIM_DIVISOR 4
+#endif
+// longest sleep per main loop pass, rdr_lib and housekeeping still run this often
+#ifndef POWER_IDLE_WAIT
+#    define POWER_IDLE_WAIT 1
+#endif
+#ifndef POWER_DEEP_WAIT
+#    define POWER_DEEP_WAIT 1
+#endif
+
+enum power_via_value {
+    id_power_dim_timeout = 7,
+    id_power_idle_timeout,
+    id_power_deep_timeout,
+};
+
+void          power_task(void);
+power_state_t power_get_state(void);
+
+bool power_via_get_value(uint8_t value_id, uint8_t *value_data);
+bool power_via_set_value(uint8_t value_id, uint8_t *value_data);
+bool power_via_save(uint8_t value_id);
@@ -0,0 +1,326 @@
+#include "quantum.h"
+#include "dynamic_keymap.h"
+#include "via.h"
+#include "qk61_via.h"
+#include "qk61_bulk.h"
+#include "keycode_cache.h"
+#include "eeprom_log.h"
+
+// payload of a data packet, raw HID packets are RAW_EPSIZE (32) bytes
+#define BULK_PAYLOAD (32 - BULK_HEADER)
+
+// outgoing data packets of a read, built in the request buffer
+static struct {
+    uint8_t *packet;
+    uint8_t  length;
+    uint8_t  count; // payload bytes in packet
+    uint8_t  seq;
+} out;
+
+// write in progress
+static struct {
+    bool     active;
+    uint8_t  status;
+    uint8_t  region;
+    uint8_t  flags;
+    uint8_t  seq;     // expected next data packet
+    uint16_t start;
+    uint16_t offset;  // next byte written
+    uint16_t end;
+    uint8_t  run;     // words left in the current RLE token
+    bool     repeat;
+    uint8_t  word[2];
+    uint8_t  word_bytes;
+    uint16_t last_packet;
+} in;
+
+static uint16_t get_u16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t value) {
+    *p++ = value & 0xFF;
+    *p++ = value >> 8;
+    return p;
+}
+
+static uint16_t region_size(uint8_t region) {
+    switch (region) {
+        case BULK_KEYMAP:
+            return dynamic_keymap_get_layer_count() * MATRIX_ROWS * MATRIX_COLS * 2;
+        case BULK_MACROS:
+            return dynamic_keymap_macro_get_buffer_size();
+        default:
+            return 0;
+    }
+}
+
+static void region_read(uint8_t region, uint16_t offset, uint16_t size, uint8_t *data) {
+    if (region == BULK_KEYMAP) {
+        dynamic_keymap_get_buffer(offset, size, data);
+    } else {
+        dynamic_keymap_macro_get_buffer(offset, size, data);
+    }
+}
+
+static void region_write(uint8_t region, uint16_t offset, uint16_t size, uint8_t *data) {
+    if (region == BULK_KEYMAP) {
+        dynamic_keymap_set_buffer(offset, size, data);
+    } else {
+        dynamic_keymap_macro_set_buffer(offset, size, data);
+    }
+}
+
+static bool range_valid(uint8_t region, uint16_t offset, uint16_t size, uint8_t flags) {
+    uint16_t end = region_size(region);
+
+    // RLE works on whole words
+    return offset <= end && size <= end - offset && !((flags & BULK_RLE) && ((offset | size) & 1));
+}
+
+static uint16_t region_word(uint8_t region, uint16_t offset) {
+    uint8_t bytes[2];
+
+    region_read(region, offset, 2, bytes);
+    return (bytes[0] << 8) | bytes[1];
+}
+
+static void out_send(uint8_t flags) {
+    out.packet[2] = out.seq++;
+    out.packet[3] = flags;
+    out.packet[4] = out.count;
+    raw_hid_send(out.packet, out.length);
+    out.count = 0;
+}
+
+static void out_put(uint8_t byte) {
+    if (out.count == out.length - BULK_HEADER) {
+        out_send(0);
+    }
+    out.packet[BULK_HEADER + out.count++] = byte;
+}
+
+static void out_word(uint16_t word) {
+    out_put(word >> 8);
+    out_put(word & 0xFF);
+}
+
+static void rle_encode(uint8_t region, uint16_t offset, uint16_t words) {
+    for (uint16_t i = 0; i < words;) {
+        uint16_t word = region_word(region, offset + i * 2);
+        uint8_t  run  = 1;
+
+        while (i + run < words && run < 128 && region_word(region, offset + (i + run) * 2) == word) {
+            run++;
+        }
+        if (run > 1) {
+            out_put(0x80 | (run - 1));
+            out_word(word);
+            i += run;
+            continue;
+        }
+
+        // literals up to the next pair of equal words
+        uint8_t count = 1;
+        while (i + count < words && count < 128 && !(i + count + 1 < words && region_word(region, offset + (i + count) * 2) == region_word(region, offset + (i + count + 1) * 2))) {
+            count++;
+        }
+        out_put(count - 1);
+        for (uint8_t k = 0; k < count; k++) {
+            out_word(region_word(region, offset + (i + k) * 2));
+        }
+        i += count;
+    }
+}
+
+static void bulk_read(uint8_t *data, uint8_t length) {
+    uint8_t  region = data[2];
+    uint16_t offset = get_u16(&data[3]);
+    uint16_t size   = get_u16(&data[5]);
+    uint8_t  flags  = data[7];
+
+    if (size > BULK_READ_MAX || !range_valid(region, offset, size, flags)) {
+        data[0] = id_unhandled;
+        raw_hid_send(data, length);
+        return;
+    }
+
+    out.packet = data;
+    out.length = length;
+    out.count  = 0;
+    out.seq    = 0;
+    memset(&data[2], 0, length - 2);
+
+    if (flags & BULK_RLE) {
+        rle_encode(region, offset, size / 2);
+    } else {
+        for (uint16_t i = 0; i < size; i++) {
+            uint8_t byte;
+
+            region_read(region, offset + i, 1, &byte);
+            out_put(byte);
+        }
+    }
+    out_send(BULK_LAST);
+}
+
+// without keep what the transfer wrote is dropped, flash still holds the state before it
+static void write_end(bool keep) {
+    if (!keep && in.offset != in.start) {
+        eeprom_log_revert();
+    }
+    if (in.offset != in.start) {
+        keycode_cache_invalidate();
+    }
+    eeprom_log_hold(false);
+    in.active = false;
+}
+
+static void bulk_write_begin(uint8_t *data) {
+    uint8_t  region = data[2];
+    uint16_t offset = get_u16(&data[3]);
+    uint16_t size   = get_u16(&data[5]);
+    uint8_t  flags  = data[7];
+
+    if (in.active) {
+        write_end(false);
+    }
+    // flash must match the image for a failed transfer to roll back to it
+    eeprom_log_flush();
+    eeprom_log_hold(true);
+
+    memset(&in, 0, sizeof(in));
+    in.active      = true;
+    in.status      = !range_valid(region, offset, size, flags) ? BULK_BAD_LENGTH : eeprom_log_is_dirty() ? BULK_NO_SPACE : BULK_OK;
+    in.last_packet = timer_read();
+    in.region = region;
+    in.flags  = flags;
+    in.start  = offset;
+    in.offset = offset;
+    in.end    = offset + size;
+}
+
+// size is at most BULK_PAYLOAD: a raw packet's payload or an RLE word
+static void in_write(uint8_t *bytes, uint8_t size) {
+    uint8_t old[BULK_PAYLOAD];
+
+    if (in.offset + size > in.end) {
+        in.status = BULK_BAD_LENGTH;
+        return;
+    }
+    region_read(in.region, in.offset, size, old);
+    region_write(in.region, in.offset, size, bytes);
+    if (!eeprom_log_packs()) {
+        // the EEPROM snapshot could not hold it, stop at the last write that fits
+        region_write(in.region, in.offset, size, old);
+        in.status = BULK_NO_SPACE;
+        return;
+    }
+    in.offset += size;
+}
+
+static void rle_decode(uint8_t byte) {
+    if (!in.run) {
+        in.repeat = byte & 0x80;
+        in.run    = (byte & 0x7F) + 1;
+        return;
+    }
+    in.word[in.word_bytes++] = byte;
+    if (in.word_bytes < 2) {
+        return;
+    }
+    in.word_bytes = 0;
+    do {
+        in_write(in.word, 2);
+    } while (in.repeat && --in.run && in.status == BULK_OK);
+    if (!in.repeat) {
+        in.run--;
+    }
+}
+
+static void bulk_write_data(uint8_t *data, uint8_t length) {
+    if (!in.active || in.status != BULK_OK) {
+        return;
+    }
+    in.last_packet = timer_read();
+    if (data[2] != in.seq++) {
+        in.status = BULK_BAD_SEQUENCE;
+        return;
+    }
+
+    uint8_t count = MIN(MIN(data[4], length - BULK_HEADER), BULK_PAYLOAD);
+    if (!(in.flags & BULK_RLE)) {
+        // the payload in one write, one check that the snapshot still packs
+        if (count) {
+            in_write(&data[BULK_HEADER], count);
+        }
+        return;
+    }
+    for (uint8_t i = 0; i < count && in.status == BULK_OK; i++) {
+        rle_decode(data[BULK_HEADER + i]);
+    }
+}
+
+static void bulk_commit(uint8_t *data, uint8_t length) {
+    uint8_t status = in.status;
+
+    if (!in.active) {
+        status = BULK_NO_TRANSFER;
+    } else if (status == BULK_OK && (in.offset != in.end || in.run || in.word_bytes)) {
+        status = BULK_BAD_LENGTH;
+    }
+
+    data[2] = status;
+    put_u16(&data[3], in.offset - in.start);
+    if (in.active) {
+        write_end(status == BULK_OK);
+    }
+    if (status == BULK_OK) {
+        // one flush for the whole transfer
+        eeprom_log_flush();
+    }
+    raw_hid_send(data, length);
+}
+
+// a transfer the host stopped sending is rolled back
+void qk61_bulk_task(void) {
+    if (in.active && timer_elapsed(in.last_packet) > BULK_WRITE_TIMEOUT) {
+        write_end(false);
+    }
+}
+
+static void bulk_info(uint8_t *data, uint8_t length) {
+    uint8_t *p = &data[2];
+
+    *p++ = dynamic_keymap_get_layer_count();
+    *p++ = MATRIX_ROWS;
+    *p++ = MATRIX_COLS;
+    p    = put_u16(p, BULK_READ_MAX);
+    p    = put_u16(p, region_size(BULK_KEYMAP));
+    put_u16(p, region_size(BULK_MACROS));
+    raw_hid_send(data, length);
+}
+
+void qk61_bulk_command(uint8_t *data, uint8_t length) {
+    switch (data[1]) {
+        case id_bulk_info:
+            bulk_info(data, length);
+            break;
+        case id_bulk_read:
+            bulk_read(data, length);
+            break;
+        case id_bulk_write_begin:
+            bulk_write_begin(data);
+            break;
+        case id_bulk_write_data:
+            bulk_write_data(data, length);
+            break;
+        case id_bulk_commit:
+            bulk_commit(data, length);
+            break;
+        default:
+            data[0] = id_unhandled;
+            raw_hid_send(data, length);
+            break;
+    }
+}
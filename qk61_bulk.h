@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Bulk transfer of the dynamic keymap and the macro buffer over raw HID.
+//
+// The stock VIA protocol moves 28 bytes per round trip. id_bulk_read
+// answers one request with a stream of data packets, and a write is a
+// begin packet, data packets with no reply, and one id_bulk_commit that
+// flushes the EEPROM log once and reports whether every packet arrived.
+//
+// data packet: [id_qk61_bulk, sub id, seq, flags, count, payload...]
+//
+// With BULK_RLE the payload is a stream of tokens over 16-bit words, in
+// the byte order of the region: a header byte h, then for h < 0x80 h + 1
+// literal words, otherwise one word repeated (h & 0x7F) + 1 times.
+// Transparent layers and empty macro space shrink to a few bytes.
+// Writes land in the EEPROM RAM image as they arrive, with the log held
+// from flushing. A failed commit, a new begin or BULK_WRITE_TIMEOUT ms
+// without a packet reloads the image from flash, so a broken transfer is
+// never saved and the host resends the whole of it. Other EEPROM writes
+// made during a transfer that fails are dropped with it. Without
+// EEPROM_LOG_ENABLE the vendor driver writes each packet through and a
+// failed transfer keeps what arrived until the host resends it. A raw
+// packet, or an RLE word, that would leave the image too dense to save is
+// not written and ends the transfer with BULK_NO_SPACE.
+
+enum bulk_region {
+    BULK_KEYMAP,
+    BULK_MACROS,
+};
+
+#define BULK_RLE (1 << 0)
+#define BULK_LAST (1 << 0) // flags of the final data packet
+
+#define BULK_HEADER 5
+// bytes decoded per read request, bounds the packets sent back to back
+#ifndef BULK_READ_MAX
+#    define BULK_READ_MAX 1024
+#endif
+// a write with no packet for this long is rolled back
+#ifndef BULK_WRITE_TIMEOUT
+#    define BULK_WRITE_TIMEOUT 1000
+#endif
+
+enum bulk_status {
+    BULK_OK,
+    BULK_BAD_SEQUENCE, // a data packet was lost
+    BULK_BAD_LENGTH,   // more or less data than announced
+    BULK_NO_TRANSFER,
+    BULK_NO_SPACE, // the keymap would not fit the EEPROM snapshot, see eeprom_log.h
+};
+
+void qk61_bulk_command(uint8_t *data, uint8_t length);
+void qk61_bulk_task(void);
@@ -0,0 +1,61 @@
+#include "quantum.h"
+#include "qk61_trace.h"
+
+trace_entry_t trace_ring[TRACE_RING_SIZE];
+uint16_t      trace_head;
+uint16_t      trace_stored;
+
+static trace_entry_t change;
+static bool          change_pending;
+static uint16_t      latency[TRACE_LATENCY_BUCKETS];
+
+void trace_matrix_changed(void) {
+    trace_event(TRACE_MATRIX_CHANGE, 0);
+    change         = trace_ring[(trace_head - 1) & (TRACE_RING_SIZE - 1)];
+    change_pending = true;
+}
+
+void trace_tap_dance_finished(tap_dance_state_t *state, void *user_data) {
+    const trace_tap_dance_t *dance = user_data;
+
+    trace_event(TRACE_TAP_DANCE, state->count);
+    dance->finished(state, NULL);
+}
+
+void trace_report_sent(bool pressed) {
+    trace_event(TRACE_REPORT, pressed);
+    if (!change_pending) {
+        return;
+    }
+    change_pending = false;
+
+    const trace_entry_t *sent   = &trace_ring[(trace_head - 1) & (TRACE_RING_SIZE - 1)];
+    int32_t              reload = SysTick->LOAD + 1;
+    uint16_t             ms     = MIN((uint16_t)(sent->ms - change.ms), 1000);
+    int32_t              us     = ms * 1000 + ((int32_t)change.systick - sent->systick) * 1000 / reload;
+    uint8_t              bucket = us > 0 ? 32 - __builtin_clz(us) : 0;
+
+    bucket = MIN(bucket, TRACE_LATENCY_BUCKETS - 1);
+    if (latency[bucket] < UINT16_MAX) {
+        latency[bucket]++;
+    }
+}
+
+// index counts from the oldest entry still in the ring
+const trace_entry_t *trace_entry(uint16_t index) {
+    if (index >= trace_stored) {
+        return NULL;
+    }
+    return &trace_ring[(trace_head - trace_stored + index) & (TRACE_RING_SIZE - 1)];
+}
+
+uint16_t trace_latency_count(uint8_t bucket) {
+    return bucket < TRACE_LATENCY_BUCKETS ? latency[bucket] : 0;
+}
+
+void trace_clear(void) {
+    trace_head     = 0;
+    trace_stored   = 0;
+    change_pending = false;
+    memset(latency, 0, sizeof(latency));
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+#include "quantum.h"
+
+// Event trace and scan-to-report latency histogram.
+//
+// TRACE() stores an event with a timestamp in a RAM ring: the 1 kHz
+// system tick and the SysTick down-counter, two register reads. The
+// latency from a raw matrix change to the report of the first key
+// event it produced goes into log2 buckets of microseconds. Both are
+// read with the diag raw HID command, util/qk61_hid.py decodes them.
+//
+// Built with QK61_TRACE_ENABLE = yes in rules.mk, without it every
+// TRACE call compiles to nothing.
+
+enum trace_event {
+    TRACE_MATRIX_CHANGE = 1,
+    TRACE_DEBOUNCE_COMMIT, // arg: row
+    TRACE_RECORD_ENTER,    // arg: row << 4 | col
+    TRACE_RECORD_EXIT,     // arg: row << 4 | col
+    TRACE_TAP_DANCE,       // arg: tap count
+    TRACE_REPORT,          // arg: pressed
+};
+
+#ifndef TRACE_RING_SIZE
+#    define TRACE_RING_SIZE 64
+#endif
+// bucket n counts latencies of 2^(n-1) to 2^n - 1 us, the last one everything longer
+#define TRACE_LATENCY_BUCKETS 16
+
+_Static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "TRACE_RING_SIZE must be a power of two");
+_Static_assert(TRACE_RING_SIZE <= UINT8_MAX, "the diag trace read sends the entry count in a byte");
+
+typedef struct {
+    uint16_t ms;
+    uint16_t systick; // SysTick count, down from the reload value within ms, 16 bits up to a 65 MHz core
+    uint8_t  event;
+    uint8_t  arg;
+} trace_entry_t;
+
+#ifdef QK61_TRACE_ENABLE
+// the handlers of a traced dance, its tap_dance_actions[] user_data
+typedef struct {
+    tap_dance_user_fn_t finished;
+} trace_tap_dance_t;
+
+extern trace_entry_t trace_ring[TRACE_RING_SIZE];
+extern uint16_t      trace_head;
+extern uint16_t      trace_stored; // entries in the ring, stops at TRACE_RING_SIZE
+
+static inline void trace_event(uint8_t event, uint8_t arg) {
+    trace_entry_t *entry = &trace_ring[trace_head++ & (TRACE_RING_SIZE - 1)];
+
+    entry->ms      = chVTGetSystemTimeX();
+    entry->systick = SysTick->VAL;
+    entry->event   = event;
+    entry->arg     = arg;
+    if (trace_stored < TRACE_RING_SIZE) {
+        trace_stored++;
+    }
+}
+
+#    define TRACE(event, arg) trace_event(event, arg)
+#    define TRACE_KEY(event, key) trace_event(event, (key).row << 4 | (key).col)
+// tap_dance_actions[] entry, the finished handler runs behind one traced dispatch
+#    define ACTION_TAP_DANCE_TRACED(fn_finished, fn_reset) \
+        { .fn = {NULL, trace_tap_dance_finished, fn_reset}, .user_data = (void *)&(const trace_tap_dance_t){.finished = fn_finished} }
+
+void trace_matrix_changed(void);
+void trace_report_sent(bool pressed);
+void trace_tap_dance_finished(tap_dance_state_t *state, void *user_data);
+
+const trace_entry_t *trace_entry(uint16_t index);
+uint16_t             trace_latency_count(uint8_t bucket);
+void                 trace_clear(void);
+#else
+#    define TRACE(event, arg) ((void)0)
+#    define TRACE_KEY(event, key) ((void)0)
+#    define trace_matrix_changed() ((void)0)
+#    define trace_report_sent(pressed) ((void)0)
+#    define ACTION_TAP_DANCE_TRACED(finished, reset) ACTION_TAP_DANCE_FN_ADVANCED(NULL, finished, reset)
+#endif
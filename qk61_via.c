@@ -0,0 +1,277 @@
+#include "quantum.h"
+#include "dynamic_keymap.h"
+#include "via.h"
+#include "qk61_via.h"
+#include "tap_learn.h"
+#include "power_state.h"
+#include "debounce_stats.h"
+#include "keycode_cache.h"
+#include "eeprom_log.h"
+#include "housekeeping_sched.h"
+#include "qk61_trace.h"
+#include "wireless_queue.h"
+#include "qk61_bulk.h"
+#include "boot_profile.h"
+
+// Values of the custom VIA menus in cidoo_qk61.json live on
+// id_custom_channel. Only the value ids known here are claimed, anything
+// else falls through to the stock VIA handlers. Diagnostics have their
+// own command, see qk61_via.h.
+
+static bool custom_value_command(uint8_t *data) {
+    uint8_t  command_id = data[0];
+    uint8_t  value_id   = data[2];
+    uint8_t *value_data = &data[3];
+
+    switch (command_id) {
+        case id_custom_set_value:
+            return tap_learn_via_set_value(value_id, value_data) || power_via_set_value(value_id, value_data);
+        case id_custom_get_value:
+            return tap_learn_via_get_value(value_id, value_data) || power_via_get_value(value_id, value_data);
+        case id_custom_save:
+            return tap_learn_via_save(value_id) || power_via_save(value_id);
+        default:
+            return false;
+    }
+}
+
+// Keymap and macro writes are done here ahead of VIA so a write that
+// leaves the EEPROM image too dense to save can be taken back. VIA then
+// repeats an accepted write, which changes nothing, and sends its reply.
+static bool keymap_write_packs(uint8_t *data, uint8_t length) {
+    uint8_t old[32];
+
+    switch (data[0]) {
+        case id_dynamic_keymap_set_keycode: {
+            uint16_t keycode = dynamic_keymap_get_keycode(data[1], data[2], data[3]);
+
+            dynamic_keymap_set_keycode(data[1], data[2], data[3], (data[4] << 8) | data[5]);
+            if (eeprom_log_packs()) {
+                return true;
+            }
+            dynamic_keymap_set_keycode(data[1], data[2], data[3], keycode);
+            return false;
+        }
+        case id_dynamic_keymap_set_buffer:
+        case id_dynamic_keymap_macro_set_buffer: {
+            bool     keymap = data[0] == id_dynamic_keymap_set_buffer;
+            uint16_t offset = (data[1] << 8) | data[2];
+            uint8_t  size   = MIN(data[3], length - 4);
+
+            if (keymap) {
+                dynamic_keymap_get_buffer(offset, size, old);
+                dynamic_keymap_set_buffer(offset, size, &data[4]);
+            } else {
+                dynamic_keymap_macro_get_buffer(offset, size, old);
+                dynamic_keymap_macro_set_buffer(offset, size, &data[4]);
+            }
+            if (eeprom_log_packs()) {
+                return true;
+            }
+            if (keymap) {
+                dynamic_keymap_set_buffer(offset, size, old);
+            } else {
+                dynamic_keymap_macro_set_buffer(offset, size, old);
+            }
+            return false;
+        }
+        default:
+            return true;
+    }
+}
+
+static void read_key_bytes(uint8_t *data, uint8_t length, uint8_t (*read)(uint8_t row, uint8_t col)) {
+    uint16_t index = data[2];
+
+    for (uint8_t i = 3; i < length; i++, index++) {
+        data[i] = index < MATRIX_ROWS * MATRIX_COLS ? read(index / MATRIX_COLS, index % MATRIX_COLS) : 0;
+    }
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t value) {
+    *p++ = value & 0xFF;
+    *p++ = value >> 8;
+    return p;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t value) {
+    return put_u16(put_u16(p, value & 0xFFFF), value >> 16);
+}
+
+static void eeprom_stats(uint8_t *data) {
+    const eeprom_log_stats_t *stats = eeprom_log_stats();
+    uint8_t                  *p     = &data[2];
+
+    p = put_u16(p, stats->flushes);
+    p = put_u16(p, stats->snapshots);
+    p = put_u32(p, stats->stall_ms);
+    for (uint8_t page = 0; page < FEE_PAGE_COUNT; page++) {
+        p = put_u16(p, eeprom_log_erase_count(page));
+    }
+    put_u16(p, stats->overflows);
+}
+
+static void housekeeping_job_stats(uint8_t *data) {
+    const housekeeping_job_t   *job  = housekeeping_job(data[2]);
+    const housekeeping_stats_t *stat = housekeeping_stats(data[2]);
+    uint8_t                    *p    = &data[3];
+
+    *p++ = housekeeping_job_count();
+    if (!job) {
+        return;
+    }
+    p = put_u32(p, stat->runs);
+    p = put_u16(p, stat->runs ? MIN(stat->total_us / stat->runs, UINT16_MAX) : 0);
+    p = put_u16(p, stat->max_us);
+    p = put_u16(p, stat->overruns);
+    p = put_u16(p, stat->deferred);
+    p = put_u16(p, job->period);
+    p = put_u16(p, job->budget);
+}
+
+static void wireless_stats(uint8_t *data) {
+    const wireless_queue_stats_t *stats = wireless_queue_stats();
+    uint8_t                      *p     = &data[2];
+
+    p = put_u32(p, stats->sent);
+    p = put_u32(p, stats->total_ms);
+    p = put_u16(p, stats->max_ms);
+    p = put_u16(p, stats->merged);
+    p = put_u16(p, stats->forced);
+    for (uint8_t bucket = 0; bucket < WIRELESS_WAIT_BUCKETS; bucket++) {
+        p = put_u16(p, stats->wait[bucket]);
+    }
+}
+
+static void boot_read(uint8_t *data, uint8_t length) {
+    const boot_record_t *record = boot_profile_record(data[2]);
+    uint8_t             *p      = &data[4];
+
+    p    = put_u16(p, boot_profile_boots());
+    *p++ = BOOT_PHASES;
+    for (uint8_t phase = data[3]; p + 4 <= data + length && phase < BOOT_PHASES; phase++) {
+        p = put_u32(p, record->phase_us[phase]);
+    }
+}
+
+static void wake_stats(uint8_t *data) {
+    const boot_record_t *record = boot_profile_record(data[2]);
+    uint8_t             *p      = &data[3];
+
+    p = put_u16(p, record->wakes);
+    p = put_u32(p, record->wake_last_us);
+    put_u32(p, record->wake_max_us);
+}
+
+#ifdef QK61_TRACE_ENABLE
+static void trace_read(uint8_t *data, uint8_t length) {
+    uint8_t  index = data[2];
+    uint8_t *p     = &data[3];
+
+    *p++ = trace_stored;
+    p    = put_u16(p, SysTick->LOAD + 1);
+    for (const trace_entry_t *entry; p + sizeof(*entry) <= data + length && (entry = trace_entry(index)); index++) {
+        p    = put_u16(p, entry->ms);
+        p    = put_u16(p, entry->systick);
+        *p++ = entry->event;
+        *p++ = entry->arg;
+    }
+}
+
+static void latency_read(uint8_t *data, uint8_t length) {
+    uint8_t *p = &data[3];
+
+    for (uint8_t bucket = data[2]; p + 2 <= data + length && bucket < TRACE_LATENCY_BUCKETS; bucket++) {
+        p = put_u16(p, trace_latency_count(bucket));
+    }
+}
+#endif
+
+static bool diag_command(uint8_t *data, uint8_t length) {
+    switch (data[1]) {
+        case id_diag_chatter_count:
+            read_key_bytes(data, length, debounce_chatter_count);
+            return true;
+        case id_diag_debounce_window:
+            read_key_bytes(data, length, debounce_window);
+            return true;
+        case id_diag_chatter_clear:
+            debounce_stats_clear();
+            return true;
+        case id_diag_eeprom_stats:
+            eeprom_stats(data);
+            return true;
+        case id_diag_housekeeping_stats:
+            housekeeping_job_stats(data);
+            return true;
+        case id_diag_housekeeping_clear:
+            housekeeping_stats_clear();
+            return true;
+#ifdef QK61_TRACE_ENABLE
+        case id_diag_trace_read:
+            trace_read(data, length);
+            return true;
+        case id_diag_latency_read:
+            latency_read(data, length);
+            return true;
+        case id_diag_trace_clear:
+            trace_clear();
+            return true;
+#endif
+        case id_diag_wireless_stats:
+            wireless_stats(data);
+            return true;
+        case id_diag_wireless_clear:
+            wireless_queue_stats_clear();
+            return true;
+        case id_diag_boot_read:
+            boot_read(data, length);
+            return true;
+        case id_diag_wake_stats:
+            wake_stats(data);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool via_command_kb(uint8_t *data, uint8_t length) {
+    uint8_t command_id = data[0];
+
+    switch (command_id) {
+        case id_dynamic_keymap_set_keycode:
+        case id_dynamic_keymap_set_buffer:
+        case id_dynamic_keymap_macro_set_buffer:
+            if (!keymap_write_packs(data, length)) {
+                data[0] = id_unhandled;
+                break;
+            }
+            // fall through
+        case id_dynamic_keymap_reset:
+        case id_eeprom_reset:
+            // VIA writes the keymap after this returns, reload on the next lookup
+            keycode_cache_invalidate();
+            return false;
+        case id_custom_set_value:
+        case id_custom_get_value:
+        case id_custom_save:
+            if (data[1] != id_custom_channel || !custom_value_command(data)) {
+                return false;
+            }
+            break;
+        case id_qk61_diag:
+            if (!diag_command(data, length)) {
+                data[0] = id_unhandled;
+            }
+            break;
+        case id_qk61_bulk:
+            // streams its own replies, write data packets get none
+            qk61_bulk_command(data, length);
+            return true;
+        default:
+            return false;
+    }
+
+    raw_hid_send(data, length);
+    return true;
+}
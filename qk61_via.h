@@ -0,0 +1,49 @@
+#pragma once
+
+// Raw HID diagnostics, a command of their own next to the stock VIA ones.
+//
+// request: [id_qk61_diag, diag_id, args...]
+// reply:   the same packet with the result written from byte 2 on
+
+#define id_qk61_diag 0x80
+// bulk keymap and macro transfer, see qk61_bulk.h
+#define id_qk61_bulk 0x81
+
+enum qk61_diag_id {
+    // args: first key index (row * MATRIX_COLS + col), reply from byte 3: one byte per key
+    id_diag_chatter_count = 1,
+    id_diag_debounce_window,
+    id_diag_chatter_clear,
+    // reply from byte 2: flushes, snapshots (u16), stall ms (u32), erase count per FEE page (u16), little endian
+    id_diag_eeprom_stats,
+    // args: job index, reply from byte 3: job count, runs (u32), mean us, max us, overruns, deferred passes, period ms, budget us (u16)
+    id_diag_housekeeping_stats,
+    id_diag_housekeeping_clear,
+    // only with QK61_TRACE_ENABLE, see qk61_trace.h
+    // args: first entry, oldest is 0; reply from byte 3: entries stored, SysTick reload (u16), then 6 byte entries
+    id_diag_trace_read,
+    // args: first bucket, reply from byte 3: one u16 count per bucket
+    id_diag_latency_read,
+    id_diag_trace_clear,
+    // reply from byte 2: sent (u32), queue ms summed (u32), max queue ms, merged, forced (u16)
+    id_diag_wireless_stats,
+    id_diag_wireless_clear,
+    // args: 0 this boot or 1 the one before the last reset, first phase;
+    // reply from byte 4: resets since power-on (u16), phase count, then us since chSysInit per phase (u32)
+    id_diag_boot_read,
+    // args: 0 or 1 as above; reply from byte 3: wakes (u16), last and max wake to report us (u32)
+    id_diag_wake_stats,
+};
+
+enum qk61_bulk_id {
+    // reply from byte 2: layers, rows, cols, max read length, keymap bytes, macro bytes (u16), little endian
+    id_bulk_info = 1,
+    // args: region, offset, length (u16), flags; replies: data packets, the last one flagged
+    id_bulk_read,
+    // args: region, offset, length (u16), flags; no reply
+    id_bulk_write_begin,
+    // args: seq, payload; no reply
+    id_bulk_write_data,
+    // reply from byte 2: status, bytes written (u16)
+    id_bulk_commit,
+};
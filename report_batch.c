@@ -0,0 +1,75 @@
+#include "quantum.h"
+#include "report_batch.h"
+
+// 5-bit keycode modifiers to report modifier bits
+static uint8_t report_mods(uint16_t keycode) {
+    uint8_t mods = QK_MODS_GET_MODS(keycode);
+
+    return (mods & 0x10) ? (mods & 0x0F) << 4 : mods;
+}
+
+static bool is_batchable(uint16_t keycode) {
+    uint8_t key = QK_MODS_GET_BASIC_KEYCODE(keycode);
+
+    return keycode <= QK_MODS_MAX && (key == KC_NO || IS_BASIC_KEYCODE(key) || IS_MODIFIER_KEYCODE(key));
+}
+
+bool report_batch_add(uint16_t keycode) {
+    if (!is_batchable(keycode)) {
+        return false;
+    }
+
+    uint8_t key  = QK_MODS_GET_BASIC_KEYCODE(keycode);
+    uint8_t mods = report_mods(keycode);
+
+    // same split as register_code16: real mods for mod-only keycodes, weak mods otherwise
+    if (key == KC_NO || IS_MODIFIER_KEYCODE(key)) {
+        add_mods(mods | (key ? MOD_BIT(key) : 0));
+    } else {
+        add_weak_mods(mods);
+        add_key(key);
+    }
+    return true;
+}
+
+bool report_batch_del(uint16_t keycode) {
+    if (!is_batchable(keycode)) {
+        return false;
+    }
+
+    uint8_t key  = QK_MODS_GET_BASIC_KEYCODE(keycode);
+    uint8_t mods = report_mods(keycode);
+
+    if (key == KC_NO || IS_MODIFIER_KEYCODE(key)) {
+        del_mods(mods | (key ? MOD_BIT(key) : 0));
+    } else {
+        del_key(key);
+        del_weak_mods(mods);
+    }
+    return true;
+}
+
+void report_batch_tap(uint16_t keycode) {
+    if (!report_batch_add(keycode)) {
+        tap_code16(keycode);
+        return;
+    }
+    send_keyboard_report();
+    report_batch_del(keycode);
+    send_keyboard_report();
+}
+
+bool process_report_batch(uint16_t keycode, keyrecord_t *record) {
+    // plain keys are one report already, only fold keycodes that carry modifiers
+    if (!IS_QK_MODS(keycode) || !IS_BASIC_KEYCODE(QK_MODS_GET_BASIC_KEYCODE(keycode))) {
+        return true;
+    }
+
+    if (record->event.pressed) {
+        report_batch_add(keycode);
+    } else {
+        report_batch_del(keycode);
+    }
+    send_keyboard_report();
+    return false;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "quantum.h"
+
+// Keyboard report changes folded into as few reports as possible.
+//
+// register_code16(C(KC_C)) sends the modifiers and the key in two
+// reports, and two more on release. report_batch_add/_del only change
+// the report; the caller sends once for the whole batch. They return
+// false for keycodes that are not a basic key with modifiers, those
+// still have to go through register_code16/unregister_code16.
+
+bool report_batch_add(uint16_t keycode);
+bool report_batch_del(uint16_t keycode);
+
+// taps keycode now, one report down and one up; tap dance finished
+// handlers use it so the tap reaches the host ahead of the key that ended
+// the dance
+void report_batch_tap(uint16_t keycode);
+
+// sends modifier shortcuts (CTRL_C, ALT_F4, ...) as one report per edge
+bool process_report_batch(uint16_t keycode, keyrecord_t *record);
@@ -0,0 +1,77 @@
+#include "quantum.h"
+#include "rgb_governor.h"
+#include "boot_profile.h"
+
+static rgb_config_t last_config;
+static bool         config_changed; // since the last frame started
+
+static uint32_t cycle_limit(void) {
+    // the cycle hue moves speed / 4 + 1 steps every 256 ms, one at speed 0
+    uint8_t steps = qadd8(rgb_matrix_config.speed / 4, 1);
+
+    return MIN(MAX(256 / steps, RGB_GOVERNOR_FULL_LIMIT), RGB_GOVERNOR_STATIC_LIMIT);
+}
+
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+static uint32_t reactive_limit(void) {
+    // a splash ring has left the board after 510 ticks of speed + 1 / 256 ms
+    uint32_t fade = 510UL * 256 / ((uint16_t)rgb_matrix_config.speed + 1);
+
+    return last_matrix_activity_elapsed() < fade ? RGB_GOVERNOR_FULL_LIMIT : RGB_GOVERNOR_STATIC_LIMIT;
+}
+#endif
+
+static uint32_t frame_interval(void) {
+    if (memcmp(&last_config, &rgb_matrix_config, sizeof(last_config))) {
+        last_config    = rgb_matrix_config;
+        config_changed = true;
+    }
+    if (config_changed) {
+        return 0;
+    }
+    if (boot_profile_rgb_deferred()) {
+        return BOOT_RGB_INTERVAL;
+    }
+    if (!rgb_matrix_config.enable) {
+        return RGB_GOVERNOR_STATIC_LIMIT;
+    }
+
+    switch (rgb_matrix_config.mode) {
+        case RGB_MATRIX_CUSTOM_TABLE_CYCLE_LEFT_RIGHT:
+        case RGB_MATRIX_CUSTOM_TABLE_CYCLE_UP_DOWN:
+            return cycle_limit();
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+        case RGB_MATRIX_CUSTOM_TABLE_SPLASH:
+            return reactive_limit();
+#endif
+        default:
+            return RGB_GOVERNOR_STATIC_LIMIT;
+    }
+}
+
+void __real_rgb_matrix_task(void);
+
+static uint32_t frame_start;
+static uint8_t  frame_calls; // calls left until the frame being rendered is flushed
+
+void __wrap_rgb_matrix_task(void) {
+    if (!frame_calls) {
+        uint32_t elapsed = sync_timer_elapsed32(g_rgb_timer);
+
+        // between frames the stock task only waits to start the next one
+        if (elapsed >= RGB_MATRIX_LED_FLUSH_LIMIT && elapsed < frame_interval()) {
+            return;
+        }
+    }
+    __real_rgb_matrix_task();
+    if (frame_calls) {
+        frame_calls--;
+    } else if (g_rgb_timer != frame_start) {
+        // the stock task sets g_rgb_timer as a frame starts, let it finish;
+        // it shows the config as it is now
+        frame_start    = g_rgb_timer;
+        frame_calls    = RGB_GOVERNOR_FRAME_CALLS - 1;
+        last_config    = rgb_matrix_config;
+        config_changed = false;
+    }
+}
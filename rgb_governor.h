@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+
+// Frame interval of the RGB matrix task.
+//
+// A frame that cannot differ from the last one is not worth rendering and
+// flushing. Static effects only refresh for the rdr_lib indicators and
+// logo, cycling effects refresh once per hue step of their speed, and
+// the reactive effect runs at full rate while a splash is fading. A
+// change of the RGB config lets the next frame start at the stock limit.
+// Right after boot frames are BOOT_RGB_INTERVAL apart, see boot_profile.h.
+//
+// rgb_matrix_task is linked with --wrap (rules.mk). Between frames the
+// stock task only waits for RGB_MATRIX_LED_FLUSH_LIMIT ms to pass since
+// the last start; the wrapper holds the next start back until the
+// governed interval has passed. A frame renders over several calls and
+// can take longer than the limit when the main loop is slow, so the
+// wrapper counts the calls of a frame from its start, seen as a new
+// g_rgb_timer, and passes them all through until it is flushed.
+
+#ifndef RGB_GOVERNOR_FULL_LIMIT
+#    define RGB_GOVERNOR_FULL_LIMIT RGB_MATRIX_LED_FLUSH_LIMIT
+#endif
+
+// indicator blinks and the logo animation still need frames
+#ifndef RGB_GOVERNOR_STATIC_LIMIT
+#    define RGB_GOVERNOR_STATIC_LIMIT 33
+#endif
+
+// calls of the stock task from the start of a frame to its flush: one
+// per RGB_MATRIX_LED_PROCESS_LIMIT LEDs rendered, then the flush
+#define RGB_GOVERNOR_FRAME_CALLS ((RGB_MATRIX_LED_COUNT + RGB_MATRIX_LED_PROCESS_LIMIT - 1) / RGB_MATRIX_LED_PROCESS_LIMIT + 1)
+
+_Static_assert(RGB_GOVERNOR_FULL_LIMIT >= RGB_MATRIX_LED_FLUSH_LIMIT, "the stock task never starts frames faster than RGB_MATRIX_LED_FLUSH_LIMIT");
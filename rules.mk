@@ -8,7 +8,9 @@ BOARD = FS026
 EEPROM_CUSTOM = custom
 NO_USB_STARTUP_CHECK = yes
 BLUETOOTH_CUSTOM = yes
-DEBOUNCE_TYPE = asym_eager_defer_pk
+DEBOUNCE_TYPE = custom
+CUSTOM_MATRIX = lite
+RGB_MATRIX_CUSTOM_KB = yes
 
 # from keyboard/layout rules.mk
 VIA_ENABLE = yes
@@ -16,6 +18,10 @@ EEPROM_DRIVER = custom
 
 # custom lines for my firmware
 TAP_DANCE_ENABLE = yes
+# event trace and latency histogram over raw HID, see qk61_trace.h
+QK61_TRACE_ENABLE = no
+# wear-levelled EEPROM log in place of the vendor FEE driver, see eeprom_log.h
+EEPROM_LOG_ENABLE = no
 
 # to reduce firmware size
 CONSOLE_ENABLE = no
@@ -23,4 +29,29 @@ SPACE_CADET_ENABLE = no
 GRAVE_ESC_ENABLE = no 
 
 # if you renamed qk61.c->keyboard.c, add this path
-SRC +=keyboard.c
\ No newline at end of file
+SRC +=keyboard.c
+SRC += key_queue.c
+SRC += tap_resolve.c
+SRC += tap_learn.c
+SRC += user_config.c
+SRC += qk61_via.c
+SRC += matrix.c
+SRC += debounce.c
+SRC += report_batch.c
+SRC += keycode_cache.c
+SRC += rgb_governor.c
+SRC += power_state.c
+SRC += battery_governor.c
+SRC += housekeeping_sched.c
+SRC += wireless_queue.c
+SRC += qk61_bulk.c
+SRC += boot_profile.c
+# rgb_governor.c paces the start of RGB frames
+EXTRALDFLAGS += -Wl,--wrap=rgb_matrix_task
+# reports for the radio go through wireless_queue.c first
+EXTRALDFLAGS += -Wl,--wrap=bluetooth_send_keyboard -Wl,--wrap=bluetooth_send_consumer
+
+ifeq ($(strip $(QK61_TRACE_ENABLE)), yes)
+    OPT_DEFS += -DQK61_TRACE_ENABLE
+    SRC += qk61_trace.c
+endif
\ No newline at end of file
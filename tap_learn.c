@@ -0,0 +1,166 @@
+#include "quantum.h"
+#include "tap_learn.h"
+#include "user_config.h"
+
+_Static_assert(TAP_LEARN_MAX_TERM <= UINT8_MAX, "learned terms are stored in one byte");
+
+static const keypos_t tap_learn_keys[TAP_LEARN_KEY_COUNT] = {
+    {.row = 2, .col = 0},  // Tab
+    {.row = 3, .col = 0},  // Caps Lock
+    {.row = 5, .col = 9},  // Right Alt
+    {.row = 5, .col = 10}, // Menu
+};
+
+typedef struct {
+    uint16_t tap_avg8; // running tap average in 1/8 ms
+    uint16_t term;
+} tap_learn_key_t;
+
+static tap_learn_key_t keys[TAP_LEARN_KEY_COUNT];
+
+static int8_t   active = -1;
+static uint16_t active_time;
+static bool     active_interrupted;
+
+static bool     dirty = false;
+static uint32_t save_timer;
+
+static bool is_tap_keycode(uint16_t keycode) {
+    return IS_QK_TAP_DANCE(keycode) || IS_QK_LAYER_TAP(keycode) || IS_QK_MOD_TAP(keycode);
+}
+
+static int8_t tap_learn_index(keypos_t key) {
+    for (uint8_t i = 0; i < TAP_LEARN_KEY_COUNT; i++) {
+        if (tap_learn_keys[i].row == key.row && tap_learn_keys[i].col == key.col) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void tap_learn_set_term(tap_learn_key_t *key, uint16_t term) {
+    term = MIN(MAX(term, TAP_LEARN_MIN_TERM), TAP_LEARN_MAX_TERM);
+    if (key->term != term) {
+        key->term = term;
+        dirty     = true;
+    }
+}
+
+static void tap_learn_sample(tap_learn_key_t *key, uint16_t held) {
+    // released long after the term without another key, a real hold
+    if (held > key->term + TAP_LEARN_SLOW_TAP) {
+        return;
+    }
+
+    key->tap_avg8 = key->tap_avg8 ? key->tap_avg8 - key->tap_avg8 / 8 + held : held * 8;
+
+    uint16_t tap_avg = key->tap_avg8 / 8;
+    tap_learn_set_term(key, tap_avg + MAX(tap_avg / 2, TAP_LEARN_MARGIN));
+}
+
+void tap_learn_init(void) {
+    for (uint8_t i = 0; i < TAP_LEARN_KEY_COUNT; i++) {
+        uint8_t term = user_config.tap_term[i];
+
+        // 0, erased or foreign EEPROM: nothing tap_learn_set_term could have stored
+        keys[i].term = term >= TAP_LEARN_MIN_TERM && term <= TAP_LEARN_MAX_TERM ? term : TAPPING_TERM;
+        // seed the average so the first samples nudge rather than replace the stored term
+        keys[i].tap_avg8 = keys[i].term * 16 / 3;
+    }
+    dirty      = false;
+    save_timer = timer_read32();
+}
+
+void tap_learn_record(uint16_t keycode, keyrecord_t *record) {
+    int8_t index = tap_learn_index(record->event.key);
+
+    if (record->event.pressed) {
+        if (active >= 0 && index != active) {
+            active_interrupted = true;
+        }
+        if (index >= 0 && is_tap_keycode(keycode)) {
+            active             = index;
+            active_time        = record->event.time;
+            active_interrupted = false;
+        }
+        return;
+    }
+
+    if (index < 0 || index != active) {
+        return;
+    }
+    active = -1;
+
+    if (active_interrupted || (user_config.tap_learn_flags & TAP_LEARN_LOCKED)) {
+        return;
+    }
+    tap_learn_sample(&keys[index], TIMER_DIFF_16(record->event.time, active_time));
+}
+
+uint16_t tap_learn_get_term(uint16_t keycode, keyrecord_t *record) {
+    int8_t index = record ? tap_learn_index(record->event.key) : -1;
+
+    // tap dance timeouts pass an empty record, find where the keycode sits on the active layers
+    for (uint8_t i = 0; index < 0 && i < TAP_LEARN_KEY_COUNT; i++) {
+        keypos_t key = tap_learn_keys[i];
+
+        if (keymap_key_to_keycode(layer_switch_get_layer(key), key) == keycode) {
+            index = i;
+        }
+    }
+    return index < 0 ? TAPPING_TERM : keys[index].term;
+}
+
+static void tap_learn_save(void) {
+    for (uint8_t i = 0; i < TAP_LEARN_KEY_COUNT; i++) {
+        user_config.tap_term[i] = keys[i].term;
+    }
+    user_config_save();
+    dirty      = false;
+    save_timer = timer_read32();
+}
+
+void tap_learn_task(void) {
+    if (dirty && timer_elapsed32(save_timer) > TAP_LEARN_SAVE_INTERVAL) {
+        tap_learn_save();
+    }
+}
+
+bool tap_learn_via_get_value(uint8_t value_id, uint8_t *value_data) {
+    if (value_id == id_tap_learn_lock) {
+        value_data[0] = (user_config.tap_learn_flags & TAP_LEARN_LOCKED) ? 1 : 0;
+        return true;
+    }
+    if (value_id >= id_tap_learn_term && value_id < id_tap_learn_term + TAP_LEARN_KEY_COUNT) {
+        value_data[0] = keys[value_id - id_tap_learn_term].term;
+        return true;
+    }
+    return false;
+}
+
+bool tap_learn_via_set_value(uint8_t value_id, uint8_t *value_data) {
+    if (value_id == id_tap_learn_lock) {
+        if (value_data[0]) {
+            user_config.tap_learn_flags |= TAP_LEARN_LOCKED;
+        } else {
+            user_config.tap_learn_flags &= ~TAP_LEARN_LOCKED;
+        }
+        return true;
+    }
+    if (value_id >= id_tap_learn_term && value_id < id_tap_learn_term + TAP_LEARN_KEY_COUNT) {
+        tap_learn_key_t *key = &keys[value_id - id_tap_learn_term];
+
+        tap_learn_set_term(key, value_data[0]);
+        key->tap_avg8 = key->term * 16 / 3;
+        return true;
+    }
+    return false;
+}
+
+bool tap_learn_via_save(uint8_t value_id) {
+    if (value_id == id_tap_learn_lock || (value_id >= id_tap_learn_term && value_id < id_tap_learn_term + TAP_LEARN_KEY_COUNT)) {
+        tap_learn_save();
+        return true;
+    }
+    return false;
+}
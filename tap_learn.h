@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "quantum.h"
+
+// Per-key tapping term learned from how long each tap key is held.
+//
+// The tap keys are fixed matrix positions (Tab, Caps Lock, Right Alt and
+// Menu), whatever tap dance or LT keycode the keymap puts there. Left
+// Alt is a plain KC_LALT in every keymap, see mod_remap.h. Every
+// release that was not interrupted by another key is a tap sample, and
+// the term follows the average tap plus a margin within
+// [TAP_LEARN_MIN_TERM, TAP_LEARN_MAX_TERM]. Learned terms are stored in
+// user_config and can be viewed, set or locked from VIA.
+
+#ifndef TAP_LEARN_MIN_TERM
+#    define TAP_LEARN_MIN_TERM 100
+#endif
+#ifndef TAP_LEARN_MAX_TERM
+#    define TAP_LEARN_MAX_TERM 250
+#endif
+// least distance between the average tap and the term
+#ifndef TAP_LEARN_MARGIN
+#    define TAP_LEARN_MARGIN 40
+#endif
+// releases this far past the term with no other key were meant as taps
+#ifndef TAP_LEARN_SLOW_TAP
+#    define TAP_LEARN_SLOW_TAP 50
+#endif
+// learned terms are written to EEPROM at most this often
+#ifndef TAP_LEARN_SAVE_INTERVAL
+#    define TAP_LEARN_SAVE_INTERVAL 600000
+#endif
+
+#define TAP_LEARN_KEY_COUNT 4
+
+#define TAP_LEARN_LOCKED (1 << 0)
+
+enum tap_learn_via_value {
+    id_tap_learn_lock = 1,
+    id_tap_learn_term, // one value per key from here
+};
+
+void     tap_learn_init(void);
+void     tap_learn_record(uint16_t keycode, keyrecord_t *record);
+uint16_t tap_learn_get_term(uint16_t keycode, keyrecord_t *record);
+void     tap_learn_task(void);
+
+bool tap_learn_via_get_value(uint8_t value_id, uint8_t *value_data);
+bool tap_learn_via_set_value(uint8_t value_id, uint8_t *value_data);
+bool tap_learn_via_save(uint8_t value_id);
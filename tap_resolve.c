@@ -0,0 +1,33 @@
+#include "quantum.h"
+#include "tap_resolve.h"
+#include "tap_learn.h"
+
+// tap dance keycode released early, KC_NO when none
+static uint16_t early_tap_keycode = KC_NO;
+
+static uint8_t td_resolve_mode(uint16_t keycode) {
+    uint8_t index = QK_TAP_DANCE_GET_INDEX(keycode);
+
+    if (index >= td_resolve_modes_count) {
+        return 0;
+    }
+    return pgm_read_byte(&td_resolve_modes[index]);
+}
+
+void tap_resolve_record(uint16_t keycode, keyrecord_t *record) {
+    if (!IS_QK_TAP_DANCE(keycode)) {
+        return;
+    }
+    if (record->event.pressed) {
+        early_tap_keycode = KC_NO;
+    } else if (td_resolve_mode(keycode) & TD_EARLY_TAP) {
+        early_tap_keycode = keycode;
+    }
+}
+
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    if (keycode == early_tap_keycode) {
+        return 0;
+    }
+    return tap_learn_get_term(keycode, record);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "quantum.h"
+
+// Early resolution of tap dances.
+//
+// A dance flagged TD_EARLY_TAP has no multi-tap meaning, so once the key
+// goes up nothing can change the outcome: it is finished as a tap on the
+// next tap_dance_task() instead of after the full TAPPING_TERM. Holds
+// need no flag, QMK already finishes a dance as a hold on the press of
+// the interrupting key.
+//
+// Each keymap declares the modes of its dances, indexed like
+// tap_dance_actions[]:
+//
+//     const uint8_t PROGMEM td_resolve_modes[] = {
+//         [TD_WIN_LOCK] = TD_EARLY_TAP,
+//     };
+//     const uint8_t td_resolve_modes_count = ARRAY_SIZE(td_resolve_modes);
+
+#define TD_EARLY_TAP (1 << 0)
+
+extern const uint8_t td_resolve_modes[];
+extern const uint8_t td_resolve_modes_count;
+
+void tap_resolve_record(uint16_t keycode, keyrecord_t *record);
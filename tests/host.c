@@ -0,0 +1,1073 @@
+#include <stdlib.h>
+#include "host.h"
+#include "dynamic_keymap.h"
+#include "eeprom_driver.h"
+#include "via.h"
+#include "lib/rdr_lib/rdr_common.h"
+
+// Everything of QMK and ChibiOS the sources call, except what rules.mk
+// wraps: those stand-ins are in host_drivers.c, --wrap only redirects
+// calls between objects.
+
+// from the keymap, absent in module tests
+extern const uint16_t     keymaps[][MATRIX_ROWS][MATRIX_COLS] __attribute__((weak));
+extern tap_dance_action_t tap_dance_actions[] __attribute__((weak));
+
+__attribute__((weak)) uint8_t keymap_layer_count(void) {
+    return 0;
+}
+
+__attribute__((weak)) uint8_t tap_dance_count(void) {
+    return 0;
+}
+
+// --- clock ---
+
+static uint64_t now_us;
+static uint32_t last_activity;
+static uint32_t sleep_request;
+static bool     woken;
+
+static host_systick_t systick = {.LOAD = 47999, .VAL = 47999};
+host_systick_t       *SysTick = &systick;
+
+uint64_t host_now_us(void) {
+    return now_us;
+}
+
+void host_advance_us(uint32_t us) {
+    now_us += us;
+    systick.VAL = systick.LOAD - (uint32_t)(now_us % 1000) * (systick.LOAD + 1) / 1000;
+}
+
+void host_advance(uint32_t ms) {
+    host_advance_us(ms * 1000);
+}
+
+uint32_t timer_read32(void) {
+    return now_us / 1000;
+}
+
+uint16_t timer_read(void) {
+    return timer_read32();
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+    return TIMER_DIFF_16(timer_read(), last);
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+    return TIMER_DIFF_32(timer_read32(), last);
+}
+
+uint32_t sync_timer_elapsed32(uint32_t last) {
+    return timer_elapsed32(last);
+}
+
+void host_activity(void) {
+    last_activity = timer_read32();
+}
+
+uint32_t last_input_activity_elapsed(void) {
+    return timer_elapsed32(last_activity);
+}
+
+uint32_t last_matrix_activity_elapsed(void) {
+    return timer_elapsed32(last_activity);
+}
+
+systime_t chVTGetSystemTimeX(void) {
+    return timer_read32();
+}
+
+void chSysLockFromISR(void) {}
+
+void chSysUnlockFromISR(void) {}
+
+// the main loop cannot block here, the sleep is handed to the caller
+void chThdSleepMilliseconds(uint32_t ms) {
+    sleep_request = MAX(sleep_request, ms);
+}
+
+void chBSemObjectInit(binary_semaphore_t *sem, bool taken) {
+    sem->taken = taken;
+}
+
+void chBSemReset(binary_semaphore_t *sem, bool taken) {
+    sem->taken = taken;
+}
+
+void chBSemSignalI(binary_semaphore_t *sem) {
+    sem->taken = false;
+    woken      = true;
+}
+
+int chBSemWaitTimeout(binary_semaphore_t *sem, sysinterval_t timeout) {
+    if (!sem->taken) {
+        sem->taken = true;
+        return 0;
+    }
+    chThdSleepMilliseconds(timeout);
+    return -1;
+}
+
+uint32_t host_take_sleep(void) {
+    uint32_t ms = sleep_request;
+
+    sleep_request = 0;
+    woken         = false;
+    return ms;
+}
+
+bool host_take_wake(void) {
+    bool was = woken;
+
+    woken = false;
+    return was;
+}
+
+// --- matrix pins: columns drive, rows read with pull-ups ---
+
+#define ROW_PIN 0x100
+
+static bool switches[MATRIX_ROWS][MATRIX_COLS];
+static bool col_low[MATRIX_COLS];
+static void (*line_cb[MATRIX_ROWS])(void *);
+static void *line_arg[MATRIX_ROWS];
+static bool  line_enabled[MATRIX_ROWS];
+
+static bool row_low(uint8_t row) {
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (col_low[col] && switches[row][col]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void host_switch(uint8_t row, uint8_t col, bool down) {
+    bool was_low = row_low(row);
+
+    switches[row][col] = down;
+    if (!was_low && row_low(row) && line_enabled[row] && line_cb[row]) {
+        line_cb[row](line_arg[row]);
+    }
+}
+
+bool host_switch_down(uint8_t row, uint8_t col) {
+    return switches[row][col];
+}
+
+void setPinOutput(pin_t pin) {}
+
+void setPinInputHigh(pin_t pin) {
+    if (pin < MATRIX_COLS) {
+        col_low[pin] = false;
+    }
+}
+
+void writePinLow(pin_t pin) {
+    if (pin < MATRIX_COLS) {
+        col_low[pin] = true;
+    }
+}
+
+void writePinHigh(pin_t pin) {
+    if (pin < MATRIX_COLS) {
+        col_low[pin] = false;
+    }
+}
+
+uint8_t readPin(pin_t pin) {
+    if (pin >= ROW_PIN) {
+        return !row_low(pin - ROW_PIN);
+    }
+    return !col_low[pin];
+}
+
+void palSetLineCallback(pin_t pin, void (*cb)(void *), void *arg) {
+    line_cb[pin - ROW_PIN]  = cb;
+    line_arg[pin - ROW_PIN] = arg;
+}
+
+void palEnableLineEvent(pin_t pin, uint8_t mode) {
+    line_enabled[pin - ROW_PIN] = true;
+}
+
+void palDisableLineEvent(pin_t pin) {
+    line_enabled[pin - ROW_PIN] = false;
+}
+
+// --- reports ---
+
+static report_keyboard_t keyboard_report;
+static report_keyboard_t sent_report;
+static uint8_t           real_mods;
+static uint8_t           weak_mods;
+static int16_t           current_key = -1;
+
+// NKRO off: host.c builds 6KRO reports only
+keymap_config_t keymap_config;
+
+static host_report_t report_log[HOST_REPORT_LOG];
+static uint32_t      report_count;
+
+void (*host_report_hook)(const host_report_t *report);
+
+// reports handed to the radio with the key event of each: a queue in
+// front of it may send one later, from another event or the main loop
+#define RADIO_HANDED 16
+
+static struct {
+    bool              waiting;
+    uint8_t           kind;
+    int16_t           key;
+    report_keyboard_t keyboard;
+    uint16_t          usage;
+} radio_handed[RADIO_HANDED];
+static uint8_t radio_handed_next;
+
+static void radio_hand(uint8_t kind, const report_keyboard_t *keyboard, uint16_t usage) {
+    radio_handed[radio_handed_next++ % RADIO_HANDED] = (typeof(radio_handed[0])){true, kind, current_key, keyboard ? *keyboard : (report_keyboard_t){0}, usage};
+}
+
+// the key of the newest report handed over with this content, a merged report is the later press's
+static int16_t radio_key(uint8_t kind, const report_keyboard_t *keyboard, uint16_t usage) {
+    for (uint8_t i = 1; i <= RADIO_HANDED; i++) {
+        typeof(radio_handed[0]) *handed = &radio_handed[(uint8_t)(radio_handed_next - i) % RADIO_HANDED];
+
+        if (handed->waiting && handed->kind == kind && (keyboard ? !memcmp(&handed->keyboard, keyboard, sizeof(*keyboard)) : handed->usage == usage)) {
+            handed->waiting = false;
+            return handed->key;
+        }
+    }
+    return -1;
+}
+
+void host_capture(uint8_t kind, uint8_t path, const report_keyboard_t *keyboard, uint16_t usage) {
+    host_report_t *report = &report_log[report_count++ % HOST_REPORT_LOG];
+    int16_t        key    = path == HOST_RADIO ? radio_key(kind, keyboard, usage) : current_key;
+
+    *report = (host_report_t){.us = now_us, .kind = kind, .path = path, .key = key, .usage = usage};
+    if (keyboard) {
+        report->keyboard = *keyboard;
+    }
+    if (host_report_hook) {
+        host_report_hook(report);
+    }
+}
+
+uint32_t host_report_count(void) {
+    return report_count;
+}
+
+const host_report_t *host_report(uint32_t index) {
+    if (index >= report_count || index + HOST_REPORT_LOG < report_count) {
+        return NULL;
+    }
+    return &report_log[index % HOST_REPORT_LOG];
+}
+
+void host_reports_clear(void) {
+    report_count = 0;
+}
+
+bool host_report_has_key(const host_report_t *report, uint8_t key) {
+    return memchr(report->keyboard.keys, key, KEYBOARD_REPORT_KEYS) != NULL;
+}
+
+void host_report_print(const host_report_t *report) {
+    printf("%8.3f ms %s %s", report->us / 1000.0, report->path == HOST_USB ? "usb  " : "radio", report->kind == HOST_KEYBOARD ? "keyboard" : "consumer");
+    if (report->kind == HOST_KEYBOARD) {
+        printf(" mods %02X keys", report->keyboard.mods);
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            printf(" %02X", report->keyboard.keys[i]);
+        }
+    } else {
+        printf(" usage %03X", report->usage);
+    }
+    printf("\n");
+}
+
+// rdr_lib's Key_Mode picks the path, the radio goes through bluetooth_send_*
+
+void send_keyboard_report(void) {
+    keyboard_report.mods = real_mods | weak_mods;
+    if (!memcmp(&keyboard_report, &sent_report, sizeof(sent_report))) {
+        return;
+    }
+    sent_report = keyboard_report;
+    if (Keyboard_Info.Key_Mode == QMK_USB_MODE) {
+        host_capture(HOST_KEYBOARD, HOST_USB, &keyboard_report, 0);
+    } else {
+        report_keyboard_t report = keyboard_report;
+
+        radio_hand(HOST_KEYBOARD, &report, 0);
+        bluetooth_send_keyboard(&report);
+    }
+}
+
+static void send_consumer(uint16_t usage) {
+    if (Keyboard_Info.Key_Mode == QMK_USB_MODE) {
+        host_capture(HOST_CONSUMER, HOST_USB, NULL, usage);
+    } else {
+        radio_hand(HOST_CONSUMER, NULL, usage);
+        bluetooth_send_consumer(usage);
+    }
+}
+
+static uint16_t consumer_usage(uint8_t code) {
+    switch (code) {
+        case KC_MUTE:
+            return 0xE2;
+        case KC_VOLU:
+            return 0xE9;
+        case KC_VOLD:
+            return 0xEA;
+        case KC_MNXT:
+            return 0xB5;
+        case KC_MPRV:
+            return 0xB6;
+        case KC_MSTP:
+            return 0xB7;
+        case KC_MPLY:
+            return 0xCD;
+        case KC_CALC:
+            return 0x192;
+        case KC_BRIU:
+            return 0x6F;
+        case KC_BRID:
+            return 0x70;
+        default:
+            return 0;
+    }
+}
+
+uint8_t get_mods(void) {
+    return real_mods;
+}
+
+void add_mods(uint8_t mods) {
+    real_mods |= mods;
+}
+
+void del_mods(uint8_t mods) {
+    real_mods &= ~mods;
+}
+
+void add_weak_mods(uint8_t mods) {
+    weak_mods |= mods;
+}
+
+void del_weak_mods(uint8_t mods) {
+    weak_mods &= ~mods;
+}
+
+void add_key(uint8_t key) {
+    if (memchr(keyboard_report.keys, key, KEYBOARD_REPORT_KEYS)) {
+        return;
+    }
+    uint8_t *slot = memchr(keyboard_report.keys, 0, KEYBOARD_REPORT_KEYS);
+    if (slot) {
+        *slot = key;
+    }
+}
+
+void del_key(uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report.keys[i] == key) {
+            keyboard_report.keys[i] = 0;
+        }
+    }
+}
+
+void register_code(uint8_t code) {
+    if (IS_BASIC_KEYCODE(code)) {
+        add_key(code);
+        send_keyboard_report();
+    } else if (IS_MODIFIER_KEYCODE(code)) {
+        add_mods(MOD_BIT(code));
+        send_keyboard_report();
+    } else if (IS_CONSUMER_KEYCODE(code)) {
+        send_consumer(consumer_usage(code));
+    }
+}
+
+void unregister_code(uint8_t code) {
+    if (IS_BASIC_KEYCODE(code)) {
+        del_key(code);
+        send_keyboard_report();
+    } else if (IS_MODIFIER_KEYCODE(code)) {
+        del_mods(MOD_BIT(code));
+        send_keyboard_report();
+    } else if (IS_CONSUMER_KEYCODE(code)) {
+        send_consumer(0);
+    }
+}
+
+void tap_code(uint8_t code) {
+    register_code(code);
+    unregister_code(code);
+}
+
+// 5-bit keycode modifiers to report modifier bits
+static uint8_t code16_mods(uint16_t code) {
+    uint8_t mods = IS_QK_MODS(code) ? QK_MODS_GET_MODS(code) : 0;
+
+    return (mods & 0x10) ? (mods & 0x0F) << 4 : mods;
+}
+
+void register_code16(uint16_t code) {
+    uint8_t mods = code16_mods(code);
+
+    if (mods) {
+        if (IS_MODIFIER_KEYCODE(code & 0xFF) || !(code & 0xFF)) {
+            add_mods(mods);
+        } else {
+            add_weak_mods(mods);
+        }
+        send_keyboard_report();
+    }
+    register_code(code & 0xFF);
+}
+
+void unregister_code16(uint16_t code) {
+    uint8_t mods = code16_mods(code);
+
+    unregister_code(code & 0xFF);
+    if (mods) {
+        if (IS_MODIFIER_KEYCODE(code & 0xFF) || !(code & 0xFF)) {
+            del_mods(mods);
+        } else {
+            del_weak_mods(mods);
+        }
+        send_keyboard_report();
+    }
+}
+
+void tap_code16(uint16_t code) {
+    register_code16(code);
+    unregister_code16(code);
+}
+
+// --- layers ---
+
+layer_state_t layer_state;
+layer_state_t default_layer_state = 1;
+
+void layer_on(uint8_t layer) {
+    layer_state |= (layer_state_t)1 << layer;
+}
+
+void layer_off(uint8_t layer) {
+    layer_state &= ~((layer_state_t)1 << layer);
+}
+
+void layer_move(uint8_t layer) {
+    layer_state = (layer_state_t)1 << layer;
+}
+
+void layer_clear(void) {
+    layer_state = 0;
+}
+
+static void layer_invert(uint8_t layer) {
+    layer_state ^= (layer_state_t)1 << layer;
+}
+
+uint8_t get_highest_layer(layer_state_t state) {
+    return state ? 31 - __builtin_clz(state) : 0;
+}
+
+uint8_t layer_switch_get_layer(keypos_t key) {
+    layer_state_t layers = layer_state | default_layer_state;
+
+    for (int8_t i = 31; i >= 0; i--) {
+        if ((layers & ((layer_state_t)1 << i)) && keymap_key_to_keycode(i, key) != KC_TRNS) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+__attribute__((weak)) uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    return dynamic_keymap_get_keycode(layer, key.row, key.col);
+}
+
+// --- dynamic keymap and VIA config in EEPROM ---
+
+#define KEYMAP_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2)
+#define MACRO_SIZE (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR - DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + 1)
+
+static const uint8_t via_magic[3] = {0x51, 0x36, 0x31};
+
+static void *keymap_addr(uint8_t layer, uint8_t row, uint8_t col) {
+    return (void *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + ((layer * MATRIX_ROWS + row) * MATRIX_COLS + col) * 2);
+}
+
+uint8_t dynamic_keymap_get_layer_count(void) {
+    return DYNAMIC_KEYMAP_LAYER_COUNT;
+}
+
+uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t col) {
+    uint8_t bytes[2];
+
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+        return KC_NO;
+    }
+    eeprom_read_block(bytes, keymap_addr(layer, row, col), 2);
+    return (bytes[0] << 8) | bytes[1];
+}
+
+void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t col, uint16_t keycode) {
+    uint8_t bytes[2] = {keycode >> 8, keycode & 0xFF};
+
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+        return;
+    }
+    eeprom_write_block(bytes, keymap_addr(layer, row, col), 2);
+}
+
+void dynamic_keymap_reset(void) {
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                uint16_t keycode = layer < keymap_layer_count() ? pgm_read_word(&keymaps[layer][row][col]) : KC_TRNS;
+
+                dynamic_keymap_set_keycode(layer, row, col, keycode);
+            }
+        }
+    }
+}
+
+static void buffer_copy(uint16_t base, uint16_t region, uint16_t offset, uint16_t size, uint8_t *data, bool write) {
+    for (uint16_t i = 0; i < size; i++) {
+        void *addr = (void *)(uintptr_t)(base + offset + i);
+
+        if (offset + i >= region) {
+            if (!write) {
+                data[i] = 0;
+            }
+        } else if (write) {
+            eeprom_write_block(&data[i], addr, 1);
+        } else {
+            eeprom_read_block(&data[i], addr, 1);
+        }
+    }
+}
+
+void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    buffer_copy(DYNAMIC_KEYMAP_EEPROM_ADDR, KEYMAP_SIZE, offset, size, data, false);
+}
+
+void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    buffer_copy(DYNAMIC_KEYMAP_EEPROM_ADDR, KEYMAP_SIZE, offset, size, data, true);
+}
+
+uint16_t dynamic_keymap_macro_get_buffer_size(void) {
+    return MACRO_SIZE;
+}
+
+void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    buffer_copy(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR, MACRO_SIZE, offset, size, data, false);
+}
+
+void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+    buffer_copy(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR, MACRO_SIZE, offset, size, data, true);
+}
+
+void via_read_custom_config(void *buf, uint32_t offset, uint32_t length) {
+    eeprom_read_block(buf, (void *)(uintptr_t)(HOST_VIA_CUSTOM_CONFIG_ADDR + offset), length);
+}
+
+void via_update_custom_config(const void *buf, uint32_t offset, uint32_t length) {
+    eeprom_write_block(buf, (void *)(uintptr_t)(HOST_VIA_CUSTOM_CONFIG_ADDR + offset), length);
+}
+
+// like QMK's via_init, the custom config is left as it was
+bool host_via_init(void) {
+    uint8_t magic[sizeof(via_magic)];
+    uint8_t zero[MACRO_SIZE];
+
+    eeprom_read_block(magic, (void *)HOST_VIA_MAGIC_ADDR, sizeof(magic));
+    if (!memcmp(magic, via_magic, sizeof(magic))) {
+        return false;
+    }
+    dynamic_keymap_reset();
+    memset(zero, 0, sizeof(zero));
+    dynamic_keymap_macro_set_buffer(0, sizeof(zero), zero);
+    eeprom_write_block(via_magic, (void *)HOST_VIA_MAGIC_ADDR, sizeof(via_magic));
+    return true;
+}
+
+// --- flash: the FEE pages, NOR bits only program from 1 to 0, in aligned words ---
+
+uint8_t            host_flash[FEE_PAGE_SIZE * FEE_PAGE_COUNT] __attribute__((aligned(HOST_FLASH_UNIT))) = {[0 ... FEE_PAGE_SIZE * FEE_PAGE_COUNT - 1] = 0xFF};
+host_flash_stats_t host_flash_stats;
+EFlashDriver       EFLD1;
+
+void host_flash_erase_all(void) {
+    memset(host_flash, 0xFF, sizeof(host_flash));
+}
+
+static uint32_t flash_cut_after; // operations to the cut, 0 for none
+static bool     flash_off;
+
+void host_flash_power_cut(uint32_t after) {
+    flash_cut_after = after;
+}
+
+void host_flash_power_on(void) {
+    flash_cut_after = 0;
+    flash_off       = false;
+}
+
+// true for the operation the power is cut in, torn, and every one after
+static bool flash_power_lost(bool *torn) {
+    *torn = !flash_off && flash_cut_after && !--flash_cut_after;
+    flash_off |= *torn;
+    return flash_off;
+}
+
+void eflStart(EFlashDriver *driver, const void *config) {
+    driver->started = true;
+}
+
+flash_error_t flashStartEraseSector(EFlashDriver *driver, flash_sector_t sector) {
+    uint32_t first = FEE_PAGE_BASE_ADDRESS / FEE_PAGE_SIZE;
+
+    if (!driver->started || sector < first || sector >= first + FEE_PAGE_COUNT) {
+        host_flash_stats.errors++;
+        return FLASH_ERROR_PROGRAM;
+    }
+
+    bool torn;
+
+    if (flash_power_lost(&torn)) {
+        return FLASH_NO_ERROR;
+    }
+    memset(&host_flash[(sector - first) * FEE_PAGE_SIZE], 0xFF, FEE_PAGE_SIZE);
+    host_flash_stats.erases++;
+    return FLASH_NO_ERROR;
+}
+
+flash_error_t flashWaitErase(BaseFlash *driver) {
+    return FLASH_NO_ERROR;
+}
+
+flash_error_t flashProgram(EFlashDriver *driver, flash_offset_t offset, size_t n, const uint8_t *data) {
+    if (!driver->started || offset < FEE_PAGE_BASE_ADDRESS || offset + n > FEE_PAGE_BASE_ADDRESS + sizeof(host_flash)) {
+        host_flash_stats.errors++;
+        return FLASH_ERROR_PROGRAM;
+    }
+    if ((offset | n) % HOST_FLASH_UNIT) {
+        host_flash_stats.errors++;
+        return FLASH_ERROR_PROGRAM;
+    }
+
+    uint8_t *cell = &host_flash[offset - FEE_PAGE_BASE_ADDRESS];
+    bool     torn;
+
+    if (flash_power_lost(&torn)) {
+        if (!torn) {
+            return FLASH_NO_ERROR;
+        }
+        n /= 2;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (data[i] & ~cell[i]) {
+            host_flash_stats.errors++;
+        }
+        cell[i] &= data[i];
+    }
+    host_flash_stats.programs++;
+    host_flash_stats.program_bytes += n;
+    return FLASH_NO_ERROR;
+}
+
+// --- RGB matrix state, the task is in host_drivers.c ---
+
+rgb_config_t rgb_matrix_config = {.enable = 1, .mode = RGB_MATRIX_DEFAULT_MODE, .hsv = {0, 255, RGB_MATRIX_MAXIMUM_BRIGHTNESS}, .speed = 128};
+uint32_t     g_rgb_timer;
+
+bool rgb_matrix_is_enabled(void) {
+    return rgb_matrix_config.enable;
+}
+
+void rgb_matrix_enable_noeeprom(void) {
+    rgb_matrix_config.enable = 1;
+}
+
+void rgb_matrix_disable_noeeprom(void) {
+    rgb_matrix_config.enable = 0;
+}
+
+uint8_t rgb_matrix_get_hue(void) {
+    return rgb_matrix_config.hsv.h;
+}
+
+uint8_t rgb_matrix_get_sat(void) {
+    return rgb_matrix_config.hsv.s;
+}
+
+uint8_t rgb_matrix_get_val(void) {
+    return rgb_matrix_config.hsv.v;
+}
+
+void rgb_matrix_sethsv_noeeprom(uint8_t hue, uint8_t sat, uint8_t val) {
+    rgb_matrix_config.hsv = (HSV){hue, sat, MIN(val, RGB_MATRIX_MAXIMUM_BRIGHTNESS)};
+}
+
+// --- action path, a model of QMK's action.c, action_tapping.c and process_tap_dance.c ---
+
+__attribute__((weak)) bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+__attribute__((weak)) bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+__attribute__((weak)) void post_process_record_user(uint16_t keycode, keyrecord_t *record) {}
+
+__attribute__((weak)) uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    return TAPPING_TERM;
+}
+
+static uint8_t source_layer[MATRIX_ROWS][MATRIX_COLS];
+
+enum {
+    LT_NONE,
+    LT_TAP,
+    LT_HOLD,
+};
+
+static uint8_t lt_state[MATRIX_ROWS][MATRIX_COLS];
+
+static int16_t key_index(keypos_t key) {
+    return key.row * MATRIX_COLS + key.col;
+}
+
+// the press looks the layers up, the release uses the layer its press had
+static uint16_t record_keycode(keyrecord_t *record) {
+    keypos_t key = record->event.key;
+
+    if (record->event.pressed) {
+        source_layer[key.row][key.col] = layer_switch_get_layer(key);
+    }
+    return keymap_key_to_keycode(source_layer[key.row][key.col], key);
+}
+
+// tap dance
+
+static uint16_t active_td;
+static uint16_t last_tap_time;
+static keypos_t td_key;
+
+static tap_dance_action_t *td_action(uint16_t keycode) {
+    uint8_t index = QK_TAP_DANCE_GET_INDEX(keycode);
+
+    return index < tap_dance_count() ? &tap_dance_actions[index] : NULL;
+}
+
+static void td_call(tap_dance_action_t *action, tap_dance_user_fn_t fn) {
+    if (fn) {
+        fn(&action->state, action->user_data);
+    }
+}
+
+static void td_reset(tap_dance_action_t *action) {
+    td_call(action, action->fn.on_reset);
+    action->state.count       = 0;
+    action->state.finished    = false;
+    action->state.interrupted = false;
+}
+
+static void td_finish(tap_dance_action_t *action) {
+    int16_t saved = current_key;
+
+    current_key = key_index(td_key);
+    if (!action->state.finished) {
+        action->state.finished = true;
+        td_call(action, action->fn.on_dance_finished);
+    }
+    active_td = 0;
+    if (!action->state.pressed) {
+        td_reset(action);
+    }
+    current_key = saved;
+}
+
+static bool preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed || !active_td || keycode == active_td) {
+        return false;
+    }
+
+    tap_dance_action_t *action = td_action(active_td);
+
+    action->state.interrupted          = true;
+    action->state.interrupting_keycode = keycode;
+    td_finish(action);
+    return true;
+}
+
+static bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
+    if (!IS_QK_TAP_DANCE(keycode)) {
+        return true;
+    }
+
+    tap_dance_action_t *action = td_action(keycode);
+
+    if (!action) {
+        return false;
+    }
+    action->state.pressed = record->event.pressed;
+    if (record->event.pressed) {
+        last_tap_time = timer_read();
+        td_key        = record->event.key;
+        action->state.count++;
+        td_call(action, action->fn.on_each_tap);
+        active_td = action->state.finished ? 0 : keycode;
+    } else {
+        td_call(action, action->fn.on_each_release);
+        if (action->state.finished) {
+            td_reset(action);
+        }
+    }
+    return false;
+}
+
+static void tap_dance_task(void) {
+    if (!active_td || timer_elapsed(last_tap_time) <= get_tapping_term(active_td, &(keyrecord_t){})) {
+        return;
+    }
+
+    tap_dance_action_t *action = td_action(active_td);
+
+    if (!action->state.interrupted) {
+        td_finish(action);
+    }
+}
+
+#ifdef GRAVE_ESC_ENABLE
+static bool process_grave_esc(uint16_t keycode, keyrecord_t *record) {
+    static bool grave_sent;
+
+    if (keycode != QK_GESC) {
+        return true;
+    }
+
+    uint8_t mods    = get_mods();
+    bool    shifted = mods & (MOD_MASK_SHIFT | MOD_MASK_GUI);
+
+#    ifdef GRAVE_ESC_ALT_OVERRIDE
+    if (mods & MOD_MASK_ALT) {
+        shifted = false;
+    }
+#    endif
+#    ifdef GRAVE_ESC_CTRL_OVERRIDE
+    if (mods & MOD_MASK_CTRL) {
+        shifted = false;
+    }
+#    endif
+#    ifdef GRAVE_ESC_GUI_OVERRIDE
+    if (mods & MOD_MASK_GUI) {
+        shifted = false;
+    }
+#    endif
+
+    if (record->event.pressed) {
+        grave_sent = shifted;
+        add_key(shifted ? KC_GRV : KC_ESC);
+    } else {
+        del_key(grave_sent ? KC_GRV : KC_ESC);
+    }
+    send_keyboard_report();
+    return false;
+}
+#endif
+
+static bool lt_tap_next; // the layer tap being processed was tapped
+
+static void process_action(uint16_t keycode, keyrecord_t *record) {
+    keypos_t key     = record->event.key;
+    bool     pressed = record->event.pressed;
+
+    if (keycode <= QK_MODS_MAX) {
+        if (pressed) {
+            register_code16(keycode);
+        } else {
+            unregister_code16(keycode);
+        }
+    } else if (IS_QK_LAYER_TAP(keycode)) {
+        if (pressed) {
+            lt_state[key.row][key.col] = lt_tap_next ? LT_TAP : LT_HOLD;
+        }
+        if (lt_state[key.row][key.col] == LT_TAP) {
+            if (pressed) {
+                register_code(QK_LAYER_TAP_GET_TAP_KEYCODE(keycode));
+            } else {
+                unregister_code(QK_LAYER_TAP_GET_TAP_KEYCODE(keycode));
+            }
+        } else if (pressed) {
+            layer_on(QK_LAYER_TAP_GET_LAYER(keycode));
+        } else {
+            layer_off(QK_LAYER_TAP_GET_LAYER(keycode));
+        }
+        if (!pressed) {
+            lt_state[key.row][key.col] = LT_NONE;
+        }
+    } else if (IS_QK_MOMENTARY(keycode)) {
+        if (pressed) {
+            layer_on(QK_MOMENTARY_GET_LAYER(keycode));
+        } else {
+            layer_off(QK_MOMENTARY_GET_LAYER(keycode));
+        }
+    } else if (IS_QK_TO(keycode)) {
+        if (pressed) {
+            layer_move(QK_TO_GET_LAYER(keycode));
+        }
+    } else if (IS_QK_TOGGLE_LAYER(keycode)) {
+        if (pressed) {
+            layer_invert(QK_TOGGLE_LAYER_GET_LAYER(keycode));
+        }
+    }
+}
+
+static void process_record(keyrecord_t *record) {
+    int16_t  saved   = current_key;
+    uint16_t keycode = record_keycode(record);
+
+    current_key = key_index(record->event.key);
+    // a dance finished by this press may have changed the layers
+    if (preprocess_tap_dance(keycode, record)) {
+        keycode = record_keycode(record);
+    }
+
+    bool pass = process_record_user(keycode, record) && process_tap_dance(keycode, record);
+#ifdef GRAVE_ESC_ENABLE
+    pass = pass && process_grave_esc(keycode, record);
+#endif
+    // like QMK, post processing only follows an event nothing handled
+    if (pass) {
+        process_action(keycode, record);
+        post_process_record_user(keycode, record);
+    }
+    current_key = saved;
+}
+
+// layer tap: events behind a pending LT wait until it is a tap or a hold
+
+#define TAPPING_QUEUE 8
+
+static struct {
+    bool        active;
+    keyrecord_t record;
+    uint16_t    keycode;
+    keyrecord_t queue[TAPPING_QUEUE];
+    uint8_t     count;
+} tapping;
+
+static void tapping_flush(void) {
+    for (uint8_t i = 0; i < tapping.count; i++) {
+        process_record(&tapping.queue[i]);
+    }
+    tapping.count = 0;
+}
+
+static void tapping_hold(void) {
+    tapping.active = false;
+    lt_tap_next    = false;
+    process_record(&tapping.record);
+    tapping_flush();
+}
+
+static void tapping_tap(keyrecord_t *release) {
+    tapping.active = false;
+    lt_tap_next    = true;
+    process_record(&tapping.record);
+    lt_tap_next = false;
+    process_record(release);
+    tapping_flush();
+}
+
+static void tapping_process(keyrecord_t *record) {
+    if (tapping.active) {
+        keypos_t key = tapping.record.event.key;
+
+        if (!record->event.pressed && record->event.key.row == key.row && record->event.key.col == key.col) {
+            tapping_tap(record);
+            return;
+        }
+        if (tapping.count == TAPPING_QUEUE) {
+            tapping_hold();
+            process_record(record);
+            return;
+        }
+        tapping.queue[tapping.count++] = *record;
+        return;
+    }
+
+    keypos_t key = record->event.key;
+
+    if (record->event.pressed && IS_QK_LAYER_TAP(keymap_key_to_keycode(layer_switch_get_layer(key), key))) {
+        tapping.active  = true;
+        tapping.record  = *record;
+        tapping.keycode = keymap_key_to_keycode(layer_switch_get_layer(key), key);
+        return;
+    }
+    process_record(record);
+}
+
+void action_exec(keyevent_t event) {
+    keyrecord_t record = {.event = event};
+    int16_t     saved  = current_key;
+
+    current_key = key_index(event.key);
+    if (pre_process_record_user(record_keycode(&record), &record)) {
+        tapping_process(&record);
+    }
+    current_key = saved;
+}
+
+void host_key(uint8_t row, uint8_t col, bool pressed) {
+    host_activity();
+    action_exec((keyevent_t){.key = {.col = col, .row = row}, .time = timer_read(), .type = 1, .pressed = pressed});
+}
+
+void host_action_task(void) {
+    if (tapping.active && timer_elapsed(tapping.record.event.time) >= get_tapping_term(tapping.keycode, &tapping.record)) {
+        int16_t saved = current_key;
+
+        current_key = key_index(tapping.record.event.key);
+        tapping_hold();
+        current_key = saved;
+    }
+    tap_dance_task();
+}
+
+// --- checks ---
+
+static int checks;
+static int failures;
+
+void host_check(bool ok, const char *what, const char *file, int line) {
+    checks++;
+    if (!ok) {
+        failures++;
+        printf("%s:%d: failed: %s\n", file, line, what);
+    }
+}
+
+void host_check_eq(long a, long b, const char *what, const char *file, int line) {
+    checks++;
+    if (a != b) {
+        failures++;
+        printf("%s:%d: failed: %s (%ld != %ld)\n", file, line, what, a, b);
+    }
+}
+
+int host_done(const char *name) {
+    printf("%s: %d checks, %d failed\n", name, checks, failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
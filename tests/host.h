@@ -0,0 +1,135 @@
+#pragma once
+
+// Host runtime of the tests: a virtual clock, the key matrix pins, the
+// HID reports captured, the EEPROM, flash and keymap storage, and a
+// model of QMK's action path. The firmware sources build unchanged
+// against stub/quantum.h and run on this.
+
+#include <stdio.h>
+#include "quantum.h"
+
+// EEPROM layout ahead of the dynamic keymap: EECONFIG with the kb and
+// user datablocks, then VIA's magic, layout options and custom config
+#define HOST_VIA_MAGIC_ADDR 42
+#define HOST_VIA_CUSTOM_CONFIG_ADDR 46
+#define DYNAMIC_KEYMAP_EEPROM_ADDR (HOST_VIA_CUSTOM_CONFIG_ADDR + VIA_EEPROM_CUSTOM_CONFIG_SIZE)
+#define DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR (DYNAMIC_KEYMAP_EEPROM_ADDR + DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2)
+
+_Static_assert(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR <= DYNAMIC_KEYMAP_EEPROM_MAX_ADDR, "keymap does not fit the EEPROM");
+_Static_assert(DYNAMIC_KEYMAP_EEPROM_ADDR % 2 == 0, "eeprom_log.c tags KC_TRNS as stored at an even address");
+
+// --- clock ---
+
+uint64_t host_now_us(void);
+void     host_advance_us(uint32_t us);
+void     host_advance(uint32_t ms);
+
+// a key event seen by the matrix, for last_input_activity_elapsed
+void host_activity(void);
+
+// the longest sleep asked for by the main loop since the last call, 0 for none
+uint32_t host_take_sleep(void);
+// a semaphore was signalled, an interrupt would have woken the main loop
+bool host_take_wake(void);
+
+// --- matrix ---
+
+void host_switch(uint8_t row, uint8_t col, bool down);
+bool host_switch_down(uint8_t row, uint8_t col);
+
+// press or release through action_exec at the current time, no matrix or debounce
+void host_key(uint8_t row, uint8_t col, bool pressed);
+// the per pass part of QMK's action path: layer tap timeouts and tap dance
+void host_action_task(void);
+
+// --- HID reports ---
+
+enum host_report_kind {
+    HOST_KEYBOARD,
+    HOST_CONSUMER,
+};
+
+enum host_report_path {
+    HOST_USB,
+    HOST_RADIO, // passed to rdr_lib's bluetooth_send_*
+};
+
+typedef struct {
+    uint64_t          us;
+    uint8_t           kind;
+    uint8_t           path;
+    int16_t           key; // row * MATRIX_COLS + col of the event being processed, -1 for none
+    report_keyboard_t keyboard;
+    uint16_t          usage;
+} host_report_t;
+
+#define HOST_REPORT_LOG 256
+
+// reports in order since host_reports_clear(), the newest HOST_REPORT_LOG kept
+uint32_t             host_report_count(void);
+const host_report_t *host_report(uint32_t index);
+void                 host_reports_clear(void);
+bool                 host_report_has_key(const host_report_t *report, uint8_t key);
+void                 host_report_print(const host_report_t *report);
+
+// called for every report as it is captured
+extern void (*host_report_hook)(const host_report_t *report);
+
+// reports reach the host here, the USB path or the radio senders (host_drivers.c)
+void host_capture(uint8_t kind, uint8_t path, const report_keyboard_t *keyboard, uint16_t usage);
+
+// --- storage ---
+
+extern uint8_t host_eeprom[EEPROM_SIZE];
+
+void host_flash_erase_all(void);
+
+// flash programs whole words at aligned offsets
+#define HOST_FLASH_UNIT 4
+
+typedef struct {
+    uint32_t erases;
+    uint32_t programs;
+    uint32_t program_bytes;
+    uint32_t errors; // programs of bits already cleared, unaligned or out of the FEE pages
+} host_flash_stats_t;
+
+extern host_flash_stats_t host_flash_stats;
+
+// power lost at the after-th erase or program from now: that one is torn,
+// half its bytes programmed or its page left as it was, and none after it
+// reach the flash until host_flash_power_on()
+void host_flash_power_cut(uint32_t after);
+void host_flash_power_on(void);
+
+// VIA's first boot: keymap and macros from keymaps[] and the magic
+// written, true when the EEPROM was blank
+bool host_via_init(void);
+
+// from the keymap through keymap_introspection.c, 0 without a keymap
+uint8_t keymap_layer_count(void);
+uint8_t tap_dance_count(void);
+
+// --- raw HID and RGB ---
+
+extern uint32_t host_raw_hid_packets;
+extern void (*host_raw_hid_hook)(uint8_t *data, uint8_t length);
+
+// calls of rgb_matrix_task that render a frame, as QMK splits the LEDs
+#define HOST_RGB_CHUNKS ((RGB_MATRIX_LED_COUNT + RGB_MATRIX_LED_PROCESS_LIMIT - 1) / RGB_MATRIX_LED_PROCESS_LIMIT)
+
+extern uint32_t host_rgb_frames;
+extern uint32_t host_rgb_calls;
+
+// a frame has started and is not flushed yet
+bool host_rgb_rendering(void);
+
+// --- checks ---
+
+#define CHECK(cond) host_check((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQ(a, b) host_check_eq((long)(a), (long)(b), #a " == " #b, __FILE__, __LINE__)
+
+void host_check(bool ok, const char *what, const char *file, int line);
+void host_check_eq(long a, long b, const char *what, const char *file, int line);
+// prints the summary, the exit status of a test
+int host_done(const char *name);
@@ -0,0 +1,123 @@
+#include "host.h"
+#include "eeprom_driver.h"
+#include "lib/rdr_lib/rdr_common.h"
+
+// Stand-ins for the code the firmware links against and rules.mk wraps,
+// in an object of their own: --wrap only redirects calls that cross
+// objects, so calls from host.c reach the wrappers as QMK's would.
+
+// --- the vendor EEPROM driver, plain RAM ---
+
+uint8_t host_eeprom[EEPROM_SIZE];
+
+void eeprom_driver_init(void) {}
+
+void eeprom_driver_erase(void) {
+    memset(host_eeprom, 0, sizeof(host_eeprom));
+}
+
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+
+    for (size_t i = 0; i < len; i++) {
+        ((uint8_t *)buf)[i] = offset + i < EEPROM_SIZE ? host_eeprom[offset + i] : 0;
+    }
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+
+    for (size_t i = 0; i < len && offset + i < EEPROM_SIZE; i++) {
+        host_eeprom[offset + i] = ((const uint8_t *)buf)[i];
+    }
+}
+
+// --- rdr_lib ---
+
+keyboard_info_t Keyboard_Info = {.Key_Mode = QMK_USB_MODE};
+
+bool     Usb_If_Ok;
+bool     Usb_If_Ok_Led;
+uint16_t Usb_If_Ok_Delay;
+uint16_t Usb_Change_Mode_Delay;
+bool     Usb_Change_Mode_Wakeup;
+
+void User_Keyboard_Init(void) {}
+
+void User_Keyboard_Post_Init(void) {}
+
+void User_Keyboard_Reset(void) {}
+
+void User_Led_Show(void) {}
+
+void es_chibios_user_idle_loop_hook(void) {}
+
+// the vendor keycodes are rdr_lib's, the rest goes on to QMK
+bool Key_Value_Dispose(uint16_t keycode, keyrecord_t *record) {
+    return keycode < QK_KB || keycode > QK_KB_MAX;
+}
+
+// the radio: reports handed to rdr_lib are captured as sent
+void bluetooth_send_keyboard(report_keyboard_t *report) {
+    host_capture(HOST_KEYBOARD, HOST_RADIO, report, 0);
+}
+
+void bluetooth_send_consumer(uint16_t usage) {
+    host_capture(HOST_CONSUMER, HOST_RADIO, NULL, usage);
+}
+
+// --- raw HID ---
+
+uint32_t host_raw_hid_packets;
+void (*host_raw_hid_hook)(uint8_t *data, uint8_t length);
+
+void raw_hid_send(uint8_t *data, uint8_t length) {
+    host_raw_hid_packets++;
+    if (host_raw_hid_hook) {
+        host_raw_hid_hook(data, length);
+    }
+}
+
+// --- QMK's rgb_matrix_task ---
+
+// A frame starts once RGB_MATRIX_LED_FLUSH_LIMIT ms have passed since the
+// last one started, renders a chunk of LEDs per call, then flushes; the
+// calls in between only check the time.
+enum {
+    RGB_SYNCING,
+    RGB_STARTING,
+    RGB_RENDERING,
+    RGB_FLUSHING,
+};
+
+static uint8_t rgb_state = RGB_STARTING;
+static uint8_t rgb_chunk;
+
+uint32_t host_rgb_frames;
+uint32_t host_rgb_calls;
+
+bool host_rgb_rendering(void) {
+    return rgb_state == RGB_RENDERING || rgb_state == RGB_FLUSHING;
+}
+
+void rgb_matrix_task(void) {
+    host_rgb_calls++;
+    switch (rgb_state) {
+        case RGB_SYNCING:
+            if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_LED_FLUSH_LIMIT) {
+                rgb_state = RGB_STARTING;
+            }
+            break;
+        case RGB_STARTING:
+            g_rgb_timer = timer_read32();
+            rgb_chunk   = 0;
+            // fall through
+        case RGB_RENDERING:
+            rgb_state = ++rgb_chunk < HOST_RGB_CHUNKS ? RGB_RENDERING : RGB_FLUSHING;
+            break;
+        case RGB_FLUSHING:
+            host_rgb_frames++;
+            rgb_state = RGB_SYNCING;
+            break;
+    }
+}
@@ -0,0 +1,12 @@
+// The keymap built into this object, as QMK's keymap_introspection.c
+// does, so the sizes of its tables are known outside it
+
+#include KEYMAP_C
+
+uint8_t keymap_layer_count(void) {
+    return ARRAY_SIZE(keymaps);
+}
+
+uint8_t tap_dance_count(void) {
+    return ARRAY_SIZE(tap_dance_actions);
+}
@@ -0,0 +1,293 @@
+#include <stdlib.h>
+#include <time.h>
+#include "host.h"
+#include "matrix.h"
+#include "debounce.h"
+#include "eeprom_driver.h"
+#include "lib/rdr_lib/rdr_common.h"
+#include "wireless_queue.h"
+
+// A keymap's firmware on the host: QMK's keyboard_init and main loop over
+// matrix.c, debounce.c and the action path of host.c, replaying a trace
+// of switch changes on the virtual clock.
+//
+// trace lines: <ms> <row> <col> <d|u>, # starts a comment
+//
+// Reports the CPU time of the main loop passes that handled key events,
+// per event, against idle passes, and the time from a switch press to
+// the first report sent for it. Presses that never produce a report of
+// their own (layer keys, a tap dance held to its term with nothing sent)
+// are counted apart.
+//
+// With -r the keyboard is in a radio mode: reports go through
+// wireless_queue.c to the loopback radio of host_drivers.c, and the
+// queue's own counts are printed. host.c puts a report the queue sends
+// later down to the key event that handed it over.
+//
+// usage: replay [-v] [-r] <trace> [repeat], -v prints every report
+
+#ifndef REPLAY_PASS_US
+#    define REPLAY_PASS_US 250 // main loop period while awake
+#endif
+
+#define TRACE_MAX 4096
+
+void board_init(void);
+
+typedef struct {
+    uint32_t ms;
+    uint8_t  row;
+    uint8_t  col;
+    bool     down;
+} trace_event_t;
+
+static trace_event_t trace[TRACE_MAX];
+static uint16_t      trace_count;
+
+static matrix_row_t raw[MATRIX_ROWS];
+static matrix_row_t cooked[MATRIX_ROWS];
+static matrix_row_t previous[MATRIX_ROWS];
+
+static uint64_t press_us[MATRIX_ROWS * MATRIX_COLS];
+static bool     press_waiting[MATRIX_ROWS * MATRIX_COLS];
+
+static uint32_t *event_ns;
+static uint32_t  event_count;
+static uint32_t *idle_ns;
+static uint32_t  idle_count;
+static uint32_t *latency_us;
+static uint32_t  latency_count;
+static uint32_t  presses;
+static bool      verbose;
+static bool      radio;
+
+static bool load_trace(const char *path) {
+    FILE *file = fopen(path, "r");
+    char  line[128];
+
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), file)) {
+        unsigned ms, row, col;
+        char     dir;
+
+        if (line[0] == '#' || sscanf(line, "%u %u %u %c", &ms, &row, &col, &dir) != 4) {
+            continue;
+        }
+        if (trace_count == TRACE_MAX || row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+            fprintf(stderr, "%s: bad or too many events\n", path);
+            fclose(file);
+            return false;
+        }
+        trace[trace_count++] = (trace_event_t){ms, row, col, dir == 'd'};
+    }
+    fclose(file);
+    return true;
+}
+
+static uint64_t clock_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void on_report(const host_report_t *report) {
+    if (verbose) {
+        printf("  %2d,%-2d ", report->key / MATRIX_COLS, report->key % MATRIX_COLS);
+        host_report_print(report);
+    }
+    if (report->key >= 0 && press_waiting[report->key]) {
+        press_waiting[report->key] = false;
+        latency_us[latency_count++] = report->us - press_us[report->key];
+    }
+}
+
+// keyboard_init: the EEPROM, VIA, then the matrix and the user hooks
+static void boot(void) {
+    board_init();
+    eeprom_driver_init();
+    if (host_via_init()) {
+        eeconfig_init_user();
+    }
+    keyboard_pre_init_user();
+    matrix_init_custom();
+    debounce_init(MATRIX_ROWS);
+    notify_usb_device_state_change_user(USB_DEVICE_STATE_CONFIGURED);
+    keyboard_post_init_user();
+}
+
+// keyboard_task then housekeeping_task, returns the key events handled
+static uint8_t pass(void) {
+    uint8_t events  = 0;
+    bool    changed = matrix_scan_custom(raw);
+
+    if (debounce(raw, cooked, MATRIX_ROWS, changed)) {
+        host_activity();
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            matrix_row_t diff = cooked[row] ^ previous[row];
+
+            for (uint8_t col = 0; diff; col++, diff >>= 1) {
+                if (diff & 1) {
+                    action_exec((keyevent_t){.key = {.col = col, .row = row}, .time = timer_read(), .type = 1, .pressed = cooked[row] >> col & 1});
+                    events++;
+                }
+            }
+            previous[row] = cooked[row];
+        }
+    }
+    host_action_task();
+    rgb_matrix_task();
+    housekeeping_task_user();
+    return events;
+}
+
+static void apply(const trace_event_t *event, uint64_t us) {
+    uint16_t key = event->row * MATRIX_COLS + event->col;
+
+    if (event->down) {
+        press_us[key]      = us;
+        press_waiting[key] = true;
+        presses++;
+    }
+    host_switch(event->row, event->col, event->down);
+}
+
+// trace times are ms, events land anywhere within a main loop period
+static uint64_t event_us(uint32_t offset_ms, uint16_t index) {
+    return (uint64_t)(offset_ms + trace[index].ms) * 1000 + index * 97 % REPLAY_PASS_US;
+}
+
+static void run(uint32_t offset_ms) {
+    uint16_t next = 0;
+    uint64_t end  = (uint64_t)(offset_ms + trace[trace_count - 1].ms + 2000) * 1000;
+
+    while (host_now_us() < (uint64_t)offset_ms * 1000) {
+        pass();
+        host_advance_us(REPLAY_PASS_US);
+    }
+
+    while (host_now_us() < end) {
+        while (next < trace_count && event_us(offset_ms, next) <= host_now_us()) {
+            apply(&trace[next], event_us(offset_ms, next));
+            next++;
+        }
+
+        uint64_t start  = clock_ns();
+        uint8_t  events = pass();
+        uint32_t took   = clock_ns() - start;
+
+        if (events) {
+            for (uint8_t i = 0; i < events; i++) {
+                event_ns[event_count++] = took / events;
+            }
+        } else {
+            idle_ns[idle_count++] = took;
+        }
+
+        // a sleeping main loop runs no passes until its timeout or a row edge
+        uint64_t wake = host_now_us() + host_take_sleep() * 1000ULL;
+
+        host_advance_us(REPLAY_PASS_US);
+        while (host_now_us() < wake) {
+            uint64_t due = next < trace_count ? event_us(offset_ms, next) : UINT64_MAX;
+
+            if (due >= wake) {
+                host_advance_us(wake - host_now_us());
+                break;
+            }
+            if (due > host_now_us()) {
+                host_advance_us(due - host_now_us());
+            }
+            apply(&trace[next++], due);
+            if (host_take_wake()) {
+                break;
+            }
+        }
+    }
+}
+
+static int compare(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentile(uint32_t *values, uint32_t count, uint8_t p) {
+    return count ? values[(uint64_t)(count - 1) * p / 100] : 0;
+}
+
+int main(int argc, char **argv) {
+    const char *name = argv[0];
+
+    for (; argc > 1 && argv[1][0] == '-'; argv++, argc--) {
+        if (!strcmp(argv[1], "-v")) {
+            verbose = true;
+        } else if (!strcmp(argv[1], "-r")) {
+            radio = true;
+        } else {
+            argc = 0;
+            break;
+        }
+    }
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s [-v] [-r] <trace> [repeat]\n", name);
+        return EXIT_FAILURE;
+    }
+    if (!load_trace(argv[1]) || !trace_count) {
+        return EXIT_FAILURE;
+    }
+
+    uint32_t repeat = argc > 2 ? atoi(argv[2]) : 1;
+    uint32_t span   = trace[trace_count - 1].ms + 2000;
+
+    event_ns   = calloc(trace_count * repeat, sizeof(*event_ns));
+    latency_us = calloc(trace_count * repeat, sizeof(*latency_us));
+    idle_ns    = calloc((uint64_t)(span + 2000) * repeat * 1000 / REPLAY_PASS_US, sizeof(*idle_ns));
+    host_report_hook = on_report;
+    if (radio) {
+        Keyboard_Info.Key_Mode = QMK_USB_MODE + 1;
+    }
+
+    boot();
+    // past the boot, lighting no longer deferred
+    for (uint32_t i = 0; i < repeat; i++) {
+        run(2000 + i * span);
+    }
+
+    uint32_t silent = presses - latency_count;
+
+    qsort(event_ns, event_count, sizeof(*event_ns), compare);
+    qsort(idle_ns, idle_count, sizeof(*idle_ns), compare);
+    qsort(latency_us, latency_count, sizeof(*latency_us), compare);
+
+    printf("%s%s: %u events, %u reports\n", argv[1], radio ? " (radio)" : "", event_count, host_report_count());
+    printf("  cost per event ns: p50 %u p99 %u max %u; idle pass ns: p50 %u p99 %u\n", percentile(event_ns, event_count, 50), percentile(event_ns, event_count, 99), percentile(event_ns, event_count, 100), percentile(idle_ns, idle_count, 50), percentile(idle_ns, idle_count, 99));
+    printf("  press to report ms: p50 %.3f p90 %.3f p99 %.3f max %.3f, %u presses without a report\n", percentile(latency_us, latency_count, 50) / 1000.0, percentile(latency_us, latency_count, 90) / 1000.0, percentile(latency_us, latency_count, 99) / 1000.0, percentile(latency_us, latency_count, 100) / 1000.0, silent);
+    if (radio) {
+        const wireless_queue_stats_t *stats = wireless_queue_stats();
+
+        printf("  radio queue: %u sent, %u merged, %u forced, queue ms mean %.2f max %u\n", stats->sent, stats->merged, stats->forced, stats->sent ? (double)stats->total_ms / stats->sent : 0.0, stats->max_ms);
+        CHECK(stats->sent > 0);
+    }
+
+    // every switch is up at the end of a trace, nothing may be left held
+    const host_report_t *last = NULL;
+    for (uint32_t i = host_report_count(); i-- > 0 && !last;) {
+        if (host_report(i)->kind == HOST_KEYBOARD) {
+            last = host_report(i);
+        }
+    }
+    CHECK(last != NULL);
+    if (last) {
+        static const uint8_t none[KEYBOARD_REPORT_KEYS];
+
+        CHECK_EQ(last->keyboard.mods, 0);
+        CHECK(!memcmp(last->keyboard.keys, none, sizeof(none)));
+    }
+    CHECK_EQ(event_count, trace_count * repeat);
+    return host_done("replay");
+}
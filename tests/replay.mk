@@ -0,0 +1,26 @@
+# The replay binary of one keymap, built from the SRC, OPT_DEFS and link
+# flags of its firmware: rules.mk, the keymap's rules.mk and
+# post_rules.mk are read in QMK's order. Called from Makefile.
+
+ROOT := ..
+
+include $(ROOT)/rules.mk
+include $(ROOT)/keymaps/$(KEYMAP)/rules.mk
+include $(ROOT)/post_rules.mk
+
+# the features QMK's common_features.mk would turn on
+ifeq ($(strip $(TAP_DANCE_ENABLE)), yes)
+    OPT_DEFS += -DTAP_DANCE_ENABLE
+endif
+ifeq ($(strip $(GRAVE_ESC_ENABLE)), yes)
+    OPT_DEFS += -DGRAVE_ESC_ENABLE
+endif
+ifeq ($(strip $(VIA_ENABLE)), yes)
+    OPT_DEFS += -DVIA_ENABLE
+endif
+
+REPLAY_SRC := $(addprefix $(ROOT)/,$(SRC)) host.c host_drivers.c keymap_introspection.c replay.c
+REPLAY_DEFS := $(OPT_DEFS) -DKEYMAP_CONFIG_H=\"keymaps/$(KEYMAP)/config.h\" -DKEYMAP_C=\"keymaps/$(KEYMAP)/keymap.c\" -DQMK_KEYBOARD_H=\"qk61.h\"
+
+$(BUILD)/replay_$(KEYMAP): $(REPLAY_SRC) $(ROOT)/rules.mk $(ROOT)/post_rules.mk $(wildcard $(ROOT)/*.h $(ROOT)/keymaps/$(KEYMAP)/* stub/*.h *.h) | $(BUILD)/qmk
+	$(CC) $(CFLAGS) $(REPLAY_DEFS) $(INCLUDES) -o $@ $(REPLAY_SRC) $(EXTRALDFLAGS)
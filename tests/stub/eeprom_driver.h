@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// EEPROM driver entry points, as in QMK's eeprom_driver.h and eeprom.h
+
+void eeprom_driver_init(void);
+void eeprom_driver_erase(void);
+void eeprom_read_block(void *buf, const void *addr, size_t len);
+void eeprom_write_block(const void *buf, void *addr, size_t len);
@@ -0,0 +1,47 @@
+#pragma once
+
+// The rdr_lib symbols this tree uses, for host builds. The vendor header
+// is not public: names are the ones called here, types are what the
+// calls need, nothing else of Keyboard_Info is assumed.
+
+#include "quantum.h"
+
+// Key_Mode of a wired connection, the other values are the radio modes
+#define QMK_USB_MODE 0
+
+typedef struct {
+    uint8_t Key_Mode;
+} keyboard_info_t;
+
+extern keyboard_info_t Keyboard_Info;
+
+extern bool     Usb_If_Ok;
+extern bool     Usb_If_Ok_Led;
+extern uint16_t Usb_If_Ok_Delay;
+extern uint16_t Usb_Change_Mode_Delay;
+extern bool     Usb_Change_Mode_Wakeup;
+
+// vendor keycodes of the keymaps, handled by Key_Value_Dispose
+enum rdr_keycodes {
+    LOGO_TOG = QK_KB,
+    LOGO_MOD,
+    LOGO_HUI,
+    LOGO_HUD,
+    LOGO_VAI,
+    LOGO_VAD,
+    LOGO_SPI,
+    LOGO_SPD,
+    MD_BLE1,
+    MD_BLE2,
+    MD_BLE3,
+    MD_24G,
+    U_EE_CLR,
+    QK_BAT,
+};
+
+void User_Keyboard_Init(void);
+void User_Keyboard_Post_Init(void);
+void User_Keyboard_Reset(void);
+void User_Led_Show(void);
+void es_chibios_user_idle_loop_hook(void);
+bool Key_Value_Dispose(uint16_t keycode, keyrecord_t *record);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint16_t matrix_row_t;
+
+#define MATRIX_ROW_SHIFTER ((matrix_row_t)1)
+
+void matrix_init_custom(void);
+bool matrix_scan_custom(matrix_row_t current_matrix[]);
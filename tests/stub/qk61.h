@@ -0,0 +1,25 @@
+#pragma once
+
+// QMK_KEYBOARD_H of the host builds: the layout macro QMK generates from
+// info.json, matrix positions in the order of its layout
+
+#include "quantum.h"
+
+// clang-format off
+#define LAYOUT_tkl_ansi( \
+    k00, k11, k12, k13, k14, k15, k16, k17, k18, k19, k1A, k1B, k1C, k1D, \
+    k20, k21, k22, k23, k24, k25, k26, k27, k28, k29, k2A, k2B, k2C, k2D, \
+    k30, k31, k32, k33, k34, k35, k36, k37, k38, k39, k3A, k3B, k3D, \
+    k40, k42, k43, k44, k45, k46, k47, k48, k49, k4A, k4B, k4D, \
+    k50, k51, k52, k55, k59, k5A, k5B, k5C \
+) { \
+    { k00,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO }, \
+    { KC_NO, k11,   k12,   k13,   k14,   k15,   k16,   k17,   k18,   k19,   k1A,   k1B,   k1C,   k1D,   KC_NO, KC_NO }, \
+    { k20,   k21,   k22,   k23,   k24,   k25,   k26,   k27,   k28,   k29,   k2A,   k2B,   k2C,   k2D,   KC_NO, KC_NO }, \
+    { k30,   k31,   k32,   k33,   k34,   k35,   k36,   k37,   k38,   k39,   k3A,   k3B,   KC_NO, k3D,   KC_NO, KC_NO }, \
+    { k40,   KC_NO, k42,   k43,   k44,   k45,   k46,   k47,   k48,   k49,   k4A,   k4B,   KC_NO, k4D,   KC_NO, KC_NO }, \
+    { k50,   k51,   k52,   KC_NO, KC_NO, k55,   KC_NO, KC_NO, KC_NO, k59,   k5A,   k5B,   k5C,   KC_NO, KC_NO, KC_NO }  \
+}
+// clang-format on
+
+extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
@@ -0,0 +1,570 @@
+#pragma once
+
+// The part of QMK the keyboard sources use, for host builds.
+//
+// Keycode values and the modifier encoding are QMK's, so keymaps and
+// tables indexed by keycode build unchanged. The functions are the
+// host's (host.c): a virtual clock, the HID reports captured, and a
+// small model of the action path (tap dance, layer tap, grave escape)
+// in place of QMK's. Only what this tree calls is here.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "config.h"
+#ifdef KEYMAP_CONFIG_H
+#    include KEYMAP_CONFIG_H
+#endif
+
+#define MATRIX_ROWS 6
+#define MATRIX_COLS 16
+
+#ifndef DYNAMIC_KEYMAP_LAYER_COUNT
+#    define DYNAMIC_KEYMAP_LAYER_COUNT 4
+#endif
+#ifndef DYNAMIC_KEYMAP_MACRO_COUNT
+#    define DYNAMIC_KEYMAP_MACRO_COUNT 16
+#endif
+
+#define PACKED __attribute__((packed))
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+#ifndef MIN
+#    define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#    define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define TRUE 1
+#define FALSE 0
+
+// --- keycodes ---
+
+enum qk_keycode_ranges {
+    QK_BASIC                = 0x0000,
+    QK_BASIC_MAX            = 0x00FF,
+    QK_MODS                 = 0x0100,
+    QK_MODS_MAX             = 0x1FFF,
+    QK_MOD_TAP              = 0x2000,
+    QK_MOD_TAP_MAX          = 0x3FFF,
+    QK_LAYER_TAP            = 0x4000,
+    QK_LAYER_TAP_MAX        = 0x4FFF,
+    QK_TO                   = 0x5200,
+    QK_TO_MAX               = 0x521F,
+    QK_MOMENTARY            = 0x5220,
+    QK_MOMENTARY_MAX        = 0x523F,
+    QK_TOGGLE_LAYER         = 0x5260,
+    QK_TOGGLE_LAYER_MAX     = 0x527F,
+    QK_TAP_DANCE            = 0x5700,
+    QK_TAP_DANCE_MAX        = 0x57FF,
+    QK_LIGHTING             = 0x7800,
+    QK_LIGHTING_MAX         = 0x78FF,
+    QK_QUANTUM              = 0x7C00,
+    QK_QUANTUM_MAX          = 0x7DFF,
+    QK_KB                   = 0x7E00,
+    QK_KB_MAX               = 0x7E3F,
+    QK_USER                 = 0x7E40,
+    QK_USER_MAX             = 0x7FFF,
+};
+
+enum qk_keycode_defines {
+    KC_NO   = 0x0000,
+    KC_TRNS = 0x0001,
+    KC_A    = 0x0004,
+    KC_B,
+    KC_C,
+    KC_D,
+    KC_E,
+    KC_F,
+    KC_G,
+    KC_H,
+    KC_I,
+    KC_J,
+    KC_K,
+    KC_L,
+    KC_M,
+    KC_N,
+    KC_O,
+    KC_P,
+    KC_Q,
+    KC_R,
+    KC_S,
+    KC_T,
+    KC_U,
+    KC_V,
+    KC_W,
+    KC_X,
+    KC_Y,
+    KC_Z,
+    KC_1,
+    KC_2,
+    KC_3,
+    KC_4,
+    KC_5,
+    KC_6,
+    KC_7,
+    KC_8,
+    KC_9,
+    KC_0,
+    KC_ENT,
+    KC_ESC,
+    KC_BSPC,
+    KC_TAB,
+    KC_SPC,
+    KC_MINS,
+    KC_EQL,
+    KC_LBRC,
+    KC_RBRC,
+    KC_BSLS,
+    KC_NUHS,
+    KC_SCLN,
+    KC_QUOT,
+    KC_GRV,
+    KC_COMM,
+    KC_DOT,
+    KC_SLSH,
+    KC_CAPS,
+    KC_F1,
+    KC_F2,
+    KC_F3,
+    KC_F4,
+    KC_F5,
+    KC_F6,
+    KC_F7,
+    KC_F8,
+    KC_F9,
+    KC_F10,
+    KC_F11,
+    KC_F12,
+    KC_PSCR,
+    KC_SCRL,
+    KC_PAUS,
+    KC_INS,
+    KC_HOME,
+    KC_PGUP,
+    KC_DEL,
+    KC_END,
+    KC_PGDN,
+    KC_RGHT,
+    KC_LEFT,
+    KC_DOWN,
+    KC_UP,
+    KC_NUM,
+    KC_PSLS,
+    KC_PAST,
+    KC_PMNS,
+    KC_PPLS,
+    KC_PENT,
+    KC_P1,
+    KC_P2,
+    KC_P3,
+    KC_P4,
+    KC_P5,
+    KC_P6,
+    KC_P7,
+    KC_P8,
+    KC_P9,
+    KC_P0,
+    KC_PDOT,
+    KC_NUBS,
+    KC_APP,
+    KC_KB_POWER,
+    KC_PEQL,
+    KC_EXSEL = 0x00A4,
+
+    KC_MUTE = 0x00A8,
+    KC_VOLU,
+    KC_VOLD,
+    KC_MNXT,
+    KC_MPRV,
+    KC_MSTP,
+    KC_MPLY,
+    KC_CALC = 0x00B2,
+    KC_BRIU = 0x00BD,
+    KC_BRID,
+
+    KC_LCTL = 0x00E0,
+    KC_LSFT,
+    KC_LALT,
+    KC_LGUI,
+    KC_RCTL,
+    KC_RSFT,
+    KC_RALT,
+    KC_RGUI,
+
+    QK_LCTL = 0x0100,
+    QK_LSFT = 0x0200,
+    QK_LALT = 0x0400,
+    QK_LGUI = 0x0800,
+    QK_RMODS_MIN = 0x1000,
+
+    RGB_TOG = 0x7820,
+    RGB_MODE_FORWARD,
+    RGB_MODE_REVERSE,
+    RGB_HUI,
+    RGB_HUD,
+    RGB_SAI,
+    RGB_SAD,
+    RGB_VAI,
+    RGB_VAD,
+    RGB_SPI,
+    RGB_SPD,
+
+    QK_BOOTLOADER  = 0x7C00,
+    QK_GRAVE_ESCAPE = 0x7C16,
+};
+
+#define KC_RIGHT KC_RGHT
+#define KC_BRMU KC_BRIU
+#define KC_BRMD KC_BRID
+#define KC_TRANSPARENT KC_TRNS
+#define _______ KC_TRNS
+#define XXXXXXX KC_NO
+#define QK_GESC QK_GRAVE_ESCAPE
+#define RGB_MOD RGB_MODE_FORWARD
+#define RGB_RMOD RGB_MODE_REVERSE
+
+#define LCTL(kc) (QK_LCTL | (kc))
+#define LSFT(kc) (QK_LSFT | (kc))
+#define LALT(kc) (QK_LALT | (kc))
+#define LGUI(kc) (QK_LGUI | (kc))
+#define C(kc) LCTL(kc)
+#define S(kc) LSFT(kc)
+#define A(kc) LALT(kc)
+#define G(kc) LGUI(kc)
+
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer) & 0xF) << 8) | ((kc) & 0xFF))
+#define TO(layer) (QK_TO | ((layer) & 0x1F))
+#define MO(layer) (QK_MOMENTARY | ((layer) & 0x1F))
+#define TG(layer) (QK_TOGGLE_LAYER | ((layer) & 0x1F))
+#define TD(index) (QK_TAP_DANCE | ((index) & 0xFF))
+
+#define IS_QK_MODS(code) ((code) >= QK_MODS && (code) <= QK_MODS_MAX)
+#define IS_QK_MOD_TAP(code) ((code) >= QK_MOD_TAP && (code) <= QK_MOD_TAP_MAX)
+#define IS_QK_LAYER_TAP(code) ((code) >= QK_LAYER_TAP && (code) <= QK_LAYER_TAP_MAX)
+#define IS_QK_TO(code) ((code) >= QK_TO && (code) <= QK_TO_MAX)
+#define IS_QK_MOMENTARY(code) ((code) >= QK_MOMENTARY && (code) <= QK_MOMENTARY_MAX)
+#define IS_QK_TOGGLE_LAYER(code) ((code) >= QK_TOGGLE_LAYER && (code) <= QK_TOGGLE_LAYER_MAX)
+#define IS_QK_TAP_DANCE(code) ((code) >= QK_TAP_DANCE && (code) <= QK_TAP_DANCE_MAX)
+
+#define QK_MODS_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MODS_GET_BASIC_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_MOD_TAP_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MOD_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_LAYER_TAP_GET_LAYER(kc) (((kc) >> 8) & 0xF)
+#define QK_LAYER_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_TO_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_MOMENTARY_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_TOGGLE_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_TAP_DANCE_GET_INDEX(kc) ((kc) & 0xFF)
+
+#define IS_BASIC_KEYCODE(code) ((code) >= KC_A && (code) <= KC_EXSEL)
+#define IS_CONSUMER_KEYCODE(code) ((code) >= KC_MUTE && (code) <= KC_BRID)
+#define IS_MODIFIER_KEYCODE(code) ((code) >= KC_LCTL && (code) <= KC_RGUI)
+
+// 5-bit keycode modifiers
+enum mods_5bit {
+    MOD_LCTL = 0x01,
+    MOD_LSFT = 0x02,
+    MOD_LALT = 0x04,
+    MOD_LGUI = 0x08,
+    MOD_RCTL = 0x11,
+    MOD_RSFT = 0x12,
+    MOD_RALT = 0x14,
+    MOD_RGUI = 0x18,
+};
+
+// report modifier bits
+#define MOD_BIT(code) (1 << ((code) & 0x07))
+#define MOD_MASK_CTRL (MOD_BIT(KC_LCTL) | MOD_BIT(KC_RCTL))
+#define MOD_MASK_SHIFT (MOD_BIT(KC_LSFT) | MOD_BIT(KC_RSFT))
+#define MOD_MASK_ALT (MOD_BIT(KC_LALT) | MOD_BIT(KC_RALT))
+#define MOD_MASK_GUI (MOD_BIT(KC_LGUI) | MOD_BIT(KC_RGUI))
+
+// --- events and actions ---
+
+typedef struct {
+    uint8_t col;
+    uint8_t row;
+} keypos_t;
+
+typedef struct {
+    keypos_t key;
+    uint16_t time;
+    uint8_t  type;
+    bool     pressed;
+} keyevent_t;
+
+typedef struct {
+    keyevent_t event;
+} keyrecord_t;
+
+void action_exec(keyevent_t event);
+
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record);
+bool process_record_user(uint16_t keycode, keyrecord_t *record);
+void post_process_record_user(uint16_t keycode, keyrecord_t *record);
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
+
+void register_code(uint8_t code);
+void unregister_code(uint8_t code);
+void tap_code(uint8_t code);
+void register_code16(uint16_t code);
+void unregister_code16(uint16_t code);
+void tap_code16(uint16_t code);
+
+uint8_t get_mods(void);
+void    add_mods(uint8_t mods);
+void    del_mods(uint8_t mods);
+void    add_weak_mods(uint8_t mods);
+void    del_weak_mods(uint8_t mods);
+void    add_key(uint8_t key);
+void    del_key(uint8_t key);
+void    send_keyboard_report(void);
+
+// --- keyboard hooks, keyboard.c's ---
+
+void keyboard_pre_init_user(void);
+void keyboard_post_init_user(void);
+void eeconfig_init_user(void);
+void housekeeping_task_user(void);
+bool shutdown_user(bool jump_to_bootloader);
+
+// --- layers and keymap ---
+
+typedef uint32_t layer_state_t;
+
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+
+void    layer_on(uint8_t layer);
+void    layer_off(uint8_t layer);
+void    layer_move(uint8_t layer);
+void    layer_clear(void);
+uint8_t get_highest_layer(layer_state_t state);
+uint8_t layer_switch_get_layer(keypos_t key);
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t col);
+
+// --- tap dance ---
+
+typedef struct {
+    uint16_t interrupting_keycode;
+    uint8_t  count;
+    bool     pressed : 1;
+    bool     finished : 1;
+    bool     interrupted : 1;
+} tap_dance_state_t;
+
+typedef void (*tap_dance_user_fn_t)(tap_dance_state_t *state, void *user_data);
+
+typedef struct {
+    tap_dance_state_t state;
+    struct {
+        tap_dance_user_fn_t on_each_tap;
+        tap_dance_user_fn_t on_dance_finished;
+        tap_dance_user_fn_t on_reset;
+        tap_dance_user_fn_t on_each_release;
+    } fn;
+    void *user_data;
+} tap_dance_action_t;
+
+#define ACTION_TAP_DANCE_FN_ADVANCED(user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset) \
+    { .fn = {user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset, NULL}, .user_data = NULL }
+
+extern tap_dance_action_t tap_dance_actions[];
+
+// --- timer ---
+
+#define TIMER_DIFF_16(a, b) ((uint16_t)((a) - (b)))
+#define TIMER_DIFF_32(a, b) ((uint32_t)((a) - (b)))
+
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+uint32_t sync_timer_elapsed32(uint32_t last);
+
+uint32_t last_input_activity_elapsed(void);
+uint32_t last_matrix_activity_elapsed(void);
+
+// --- reports ---
+
+#define KEYBOARD_REPORT_KEYS 6
+
+typedef struct {
+    uint8_t mods;
+    uint8_t reserved;
+    uint8_t keys[KEYBOARD_REPORT_KEYS];
+} report_keyboard_t;
+
+// magic and bootmagic settings, only the NKRO flag is read here
+typedef union {
+    uint16_t raw;
+    struct {
+        bool nkro : 1;
+    };
+} keymap_config_t;
+
+extern keymap_config_t keymap_config;
+
+void bluetooth_send_keyboard(report_keyboard_t *report);
+void bluetooth_send_consumer(uint16_t usage);
+void raw_hid_send(uint8_t *data, uint8_t length);
+
+enum usb_device_state {
+    USB_DEVICE_STATE_NO_INIT,
+    USB_DEVICE_STATE_INIT,
+    USB_DEVICE_STATE_CONFIGURED,
+    USB_DEVICE_STATE_SUSPEND,
+};
+
+void notify_usb_device_state_change_user(enum usb_device_state usb_device_state);
+
+// --- RGB matrix ---
+
+#define NO_LED 255
+
+typedef struct PACKED {
+    uint8_t h;
+    uint8_t s;
+    uint8_t v;
+} HSV;
+
+typedef union {
+    uint32_t raw;
+    struct PACKED {
+        uint8_t  enable : 2;
+        uint8_t  mode : 6;
+        HSV      hsv;
+        uint8_t  speed;
+        uint8_t  flags;
+    };
+} rgb_config_t;
+
+typedef struct PACKED {
+    uint8_t x;
+    uint8_t y;
+} led_point_t;
+
+typedef struct PACKED {
+    uint8_t     matrix_co[MATRIX_ROWS][MATRIX_COLS];
+    led_point_t point[RGB_MATRIX_LED_COUNT];
+    uint8_t     flags[RGB_MATRIX_LED_COUNT];
+} led_config_t;
+
+// LEDs rendered per call of rgb_matrix_task, QMK's default
+#ifndef RGB_MATRIX_LED_PROCESS_LIMIT
+#    define RGB_MATRIX_LED_PROCESS_LIMIT ((RGB_MATRIX_LED_COUNT + 4) / 5)
+#endif
+
+enum rgb_matrix_effects {
+    RGB_MATRIX_NONE,
+    RGB_MATRIX_CUSTOM_TABLE_SOLID_COLOR,
+    RGB_MATRIX_CUSTOM_TABLE_CYCLE_LEFT_RIGHT,
+    RGB_MATRIX_CUSTOM_TABLE_CYCLE_UP_DOWN,
+    RGB_MATRIX_CUSTOM_TABLE_SPLASH,
+};
+
+#define RGB_MATRIX_KEYREACTIVE_ENABLED
+
+// lib8tion's saturating add
+static inline uint8_t qadd8(uint8_t i, uint8_t j) {
+    unsigned sum = i + j;
+
+    return sum > 255 ? 255 : sum;
+}
+
+extern rgb_config_t rgb_matrix_config;
+extern led_config_t g_led_config;
+extern uint32_t     g_rgb_timer;
+
+void    rgb_matrix_task(void);
+bool    rgb_matrix_is_enabled(void);
+void    rgb_matrix_enable_noeeprom(void);
+void    rgb_matrix_disable_noeeprom(void);
+uint8_t rgb_matrix_get_hue(void);
+uint8_t rgb_matrix_get_sat(void);
+uint8_t rgb_matrix_get_val(void);
+void    rgb_matrix_sethsv_noeeprom(uint8_t hue, uint8_t sat, uint8_t val);
+
+// --- ChibiOS ---
+
+#define CH_CFG_ST_TIMEDELTA 0
+#define PAL_USE_CALLBACKS TRUE
+#define PAL_EVENT_MODE_FALLING_EDGE 2
+#define HAL_USE_EFL TRUE
+#define TIME_MS2I(ms) (ms)
+
+typedef uint32_t systime_t;
+typedef uint32_t sysinterval_t;
+
+// LOAD and VAL follow the virtual clock, a 48 MHz core
+typedef struct {
+    uint32_t LOAD;
+    uint32_t VAL;
+} host_systick_t;
+
+extern host_systick_t *SysTick;
+
+systime_t chVTGetSystemTimeX(void);
+void      chSysLockFromISR(void);
+void      chSysUnlockFromISR(void);
+void      chThdSleepMilliseconds(uint32_t ms);
+
+typedef struct {
+    bool taken;
+} binary_semaphore_t;
+
+void chBSemObjectInit(binary_semaphore_t *sem, bool taken);
+void chBSemReset(binary_semaphore_t *sem, bool taken);
+void chBSemSignalI(binary_semaphore_t *sem);
+int  chBSemWaitTimeout(binary_semaphore_t *sem, sysinterval_t timeout);
+
+// pins: rows and columns of the matrix in host.c
+typedef uint32_t pin_t;
+
+#define MATRIX_ROW_PINS {0x100, 0x101, 0x102, 0x103, 0x104, 0x105}
+#define MATRIX_COL_PINS {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}
+
+void    setPinOutput(pin_t pin);
+void    setPinInputHigh(pin_t pin);
+void    writePinLow(pin_t pin);
+void    writePinHigh(pin_t pin);
+uint8_t readPin(pin_t pin);
+void    palSetLineCallback(pin_t pin, void (*cb)(void *), void *arg);
+void    palEnableLineEvent(pin_t pin, uint8_t mode);
+void    palDisableLineEvent(pin_t pin);
+
+void matrix_output_select_delay(void);
+void matrix_output_unselect_delay(uint8_t line, bool key_pressed);
+
+// EFL flash driver over the FEE pages of host.c, read in place like MCU flash
+typedef uint32_t flash_offset_t;
+typedef uint32_t flash_sector_t;
+typedef enum {
+    FLASH_NO_ERROR = 0,
+    FLASH_ERROR_PROGRAM,
+} flash_error_t;
+
+typedef struct {
+    bool started;
+} EFlashDriver;
+typedef EFlashDriver BaseFlash;
+
+extern EFlashDriver EFLD1;
+extern uint8_t      host_flash[];
+
+#define FEE_MCU_FLASH_BASE ((uintptr_t)host_flash - FEE_PAGE_BASE_ADDRESS)
+
+void          eflStart(EFlashDriver *driver, const void *config);
+flash_error_t flashStartEraseSector(EFlashDriver *driver, flash_sector_t sector);
+flash_error_t flashWaitErase(BaseFlash *driver);
+flash_error_t flashProgram(EFlashDriver *driver, flash_offset_t offset, size_t n, const uint8_t *data);
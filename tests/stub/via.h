@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// VIA command ids and the custom config area, as in QMK's via.h
+
+enum via_command_id {
+    id_get_protocol_version                 = 0x01,
+    id_get_keyboard_value                   = 0x02,
+    id_set_keyboard_value                   = 0x03,
+    id_dynamic_keymap_get_keycode           = 0x04,
+    id_dynamic_keymap_set_keycode           = 0x05,
+    id_dynamic_keymap_reset                 = 0x06,
+    id_custom_set_value                     = 0x07,
+    id_custom_get_value                     = 0x08,
+    id_custom_save                          = 0x09,
+    id_eeprom_reset                         = 0x0A,
+    id_bootloader_jump                      = 0x0B,
+    id_dynamic_keymap_macro_get_count       = 0x0C,
+    id_dynamic_keymap_macro_get_buffer_size = 0x0D,
+    id_dynamic_keymap_macro_get_buffer      = 0x0E,
+    id_dynamic_keymap_macro_set_buffer      = 0x0F,
+    id_dynamic_keymap_macro_reset           = 0x10,
+    id_dynamic_keymap_get_layer_count       = 0x11,
+    id_dynamic_keymap_get_buffer            = 0x12,
+    id_dynamic_keymap_set_buffer            = 0x13,
+    id_dynamic_keymap_get_encoder           = 0x14,
+    id_dynamic_keymap_set_encoder           = 0x15,
+    id_unhandled                            = 0xFF,
+};
+
+enum via_channel_id {
+    id_custom_channel         = 0,
+    id_qmk_backlight_channel  = 1,
+    id_qmk_rgblight_channel   = 2,
+    id_qmk_rgb_matrix_channel = 3,
+    id_qmk_audio_channel      = 4,
+};
+
+void via_read_custom_config(void *buf, uint32_t offset, uint32_t length);
+void via_update_custom_config(const void *buf, uint32_t offset, uint32_t length);
+// the keyboard's turn at a raw HID packet before VIA's, true when handled
+bool via_command_kb(uint8_t *data, uint8_t length);
@@ -0,0 +1,45 @@
+#include "host.h"
+#include "lib/rdr_lib/rdr_common.h"
+#include "battery_governor.h"
+
+// battery_governor.c fed the channel sums of frames rendered at its own
+// scale, as the table effects do: the LED current settles under the
+// budget on the radio and is left alone over USB.
+
+// every LED at r, g, b, scaled by the governor
+static uint16_t frames(uint16_t count, uint8_t r, uint8_t g, uint8_t b) {
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t scale = battery_governor_scale();
+
+        battery_governor_frame((uint32_t)RGB_MATRIX_LED_COUNT * (r * scale / 255 + g * scale / 255 + b * scale / 255));
+    }
+    return battery_governor_current_ma();
+}
+
+int main(void) {
+    uint16_t white = RGB_MATRIX_LED_COUNT * 3 * BATTERY_GOVERNOR_CHANNEL_MA;
+
+    Keyboard_Info.Key_Mode = QMK_USB_MODE;
+    CHECK_EQ(frames(100, 255, 255, 255), white);
+    CHECK_EQ(battery_governor_scale(), 255);
+
+    Keyboard_Info.Key_Mode = QMK_USB_MODE + 1; // a radio mode
+    // a scale step per frame is at most BATTERY_GOVERNOR_STEP
+    uint16_t settle = 255 / BATTERY_GOVERNOR_STEP + 1;
+    uint16_t ma     = frames(settle, 255, 255, 255);
+
+    CHECK(ma <= BATTERY_GOVERNOR_BUDGET_MA);
+    CHECK(ma > BATTERY_GOVERNOR_BUDGET_MA * 9 / 10);
+    printf("battery_governor: all white %u mA on USB, %u mA on the radio\n", white, ma);
+
+    // a dim frame fits, the scale climbs back to full
+    CHECK(frames(settle, 40, 0, 0) < BATTERY_GOVERNOR_BUDGET_MA);
+    CHECK_EQ(battery_governor_scale(), 255);
+
+    // back on USB the scale is full at once
+    frames(settle, 255, 255, 255);
+    Keyboard_Info.Key_Mode = QMK_USB_MODE;
+    frames(1, 255, 255, 255);
+    CHECK_EQ(battery_governor_scale(), 255);
+    return host_done("battery_governor");
+}
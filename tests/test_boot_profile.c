@@ -0,0 +1,128 @@
+#include "host.h"
+#include "boot_profile.h"
+#include "rgb_governor.h"
+#include "housekeeping_sched.h"
+#include "power_state.h"
+
+// boot_profile.c with rgb_governor.c in front of the stock task model of
+// host_drivers.c, through two boots: phases stamped once, RGB frames
+// BOOT_RGB_INTERVAL apart until the first report, a lighting key and the
+// indicators still drawn meanwhile, full rate after; wakes timed only
+// out of power idle, and a reset keeping the first boot as the previous.
+
+void __real_rgb_matrix_task(void);
+
+static power_state_t power_state = POWER_ACTIVE;
+
+uint32_t housekeeping_now_us(void) {
+    return host_now_us();
+}
+
+power_state_t power_get_state(void) {
+    return power_state;
+}
+
+// main loop passes 1 ms apart for ms, returns the RGB frames started
+static uint32_t run(uint32_t ms, bool governed) {
+    uint32_t frames = host_rgb_frames;
+
+    for (uint32_t t = 0; t < ms; t++) {
+        boot_profile_task();
+        if (governed) {
+            rgb_matrix_task();
+        } else {
+            __real_rgb_matrix_task();
+        }
+        host_advance(1);
+    }
+    return host_rgb_frames - frames;
+}
+
+static uint32_t phase_ms(uint8_t phase) {
+    return boot_profile_record(false)->phase_us[phase] / 1000;
+}
+
+static bool reached(uint8_t phase) {
+    return boot_profile_record(false)->phase_us[phase] != BOOT_NOT_REACHED;
+}
+
+int main(void) {
+    // first boot: the profile starts empty
+    boot_profile_init();
+    CHECK_EQ(boot_profile_boots(), 0);
+    CHECK_EQ(boot_profile_record(true)->phase_us[BOOT_PRE_INIT], BOOT_NOT_REACHED);
+    CHECK(!reached(BOOT_PRE_INIT));
+
+    host_advance(2);
+    boot_profile_mark(BOOT_PRE_INIT);
+    host_advance(3);
+    boot_profile_mark(BOOT_POST_INIT);
+    boot_profile_defer_rgb();
+    CHECK(boot_profile_rgb_deferred());
+    boot_profile_mark(BOOT_INIT_DONE);
+    host_advance(1);
+    boot_profile_mark(BOOT_PRE_INIT); // stamped once
+    CHECK_EQ(phase_ms(BOOT_PRE_INIT), 2);
+    CHECK_EQ(phase_ms(BOOT_POST_INIT), 5);
+
+    // the window: a frame at once for the indicators, then one per BOOT_RGB_INTERVAL
+    uint32_t window = 250;
+    uint32_t lazy   = run(window, true);
+    CHECK_EQ(phase_ms(BOOT_FIRST_SCAN), 6);
+    CHECK(boot_profile_rgb_deferred());
+    CHECK(lazy >= 1 && lazy <= window / BOOT_RGB_INTERVAL + 1);
+    CHECK(rgb_matrix_config.enable);
+
+    // a lighting key pressed in the window is drawn as soon as the stock
+    // task allows, not a BOOT_RGB_INTERVAL later, and kept
+    rgb_matrix_config.mode  = RGB_MATRIX_CUSTOM_TABLE_CYCLE_LEFT_RIGHT;
+    rgb_matrix_config.speed = 255;
+    CHECK(run(RGB_MATRIX_LED_FLUSH_LIMIT + RGB_GOVERNOR_FRAME_CALLS, true) >= 1);
+    CHECK(boot_profile_rgb_deferred());
+
+    // the first report ends the window
+    uint32_t window_end = host_now_us() / 1000;
+    boot_profile_report();
+    run(1, true);
+    CHECK(!boot_profile_rgb_deferred());
+    CHECK_EQ(phase_ms(BOOT_FIRST_REPORT), window_end);
+    uint32_t ready = phase_ms(BOOT_RGB_READY) - window_end;
+    CHECK(ready <= 1);
+    CHECK_EQ(rgb_matrix_config.mode, RGB_MATRIX_CUSTOM_TABLE_CYCLE_LEFT_RIGHT);
+    uint32_t full = run(window, true);
+    CHECK(full >= window / (RGB_GOVERNOR_FULL_LIMIT + 1) - 1);
+    CHECK(!reached(BOOT_USB_READY));
+
+    // the stock task over a window as long
+    uint32_t stock = run(window, false);
+
+    // a wake is timed from leaving matrix idle mode while power idle, not while active
+    boot_profile_wake();
+    host_advance(3);
+    power_state = POWER_IDLE;
+    boot_profile_report();
+    CHECK_EQ(boot_profile_record(false)->wakes, 1);
+    CHECK_EQ(boot_profile_record(false)->wake_last_us, 3000);
+    power_state = POWER_ACTIVE;
+    boot_profile_wake();
+    host_advance(1);
+    boot_profile_report();
+    CHECK_EQ(boot_profile_record(false)->wakes, 1);
+
+    // a reset: the first boot becomes the previous one, the window ends at
+    // BOOT_RGB_DELAY ms of the system tick with no key, past here already
+    boot_record_t first = *boot_profile_record(false);
+
+    boot_profile_init();
+    CHECK_EQ(boot_profile_boots(), 1);
+    CHECK(!memcmp(boot_profile_record(true), &first, sizeof(first)));
+    CHECK(!reached(BOOT_FIRST_REPORT));
+    CHECK_EQ(boot_profile_record(false)->wakes, 0);
+    boot_profile_defer_rgb();
+    run(1, true);
+    CHECK(!boot_profile_rgb_deferred());
+    CHECK(reached(BOOT_RGB_READY) && !reached(BOOT_FIRST_REPORT));
+
+    printf("boot_profile: RGB frames in the first %u ms, lazy %u, stock %u, after the first report %u; ready %u ms after the report\n", window, lazy, stock, full, ready);
+    return host_done("boot_profile");
+}
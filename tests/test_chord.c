@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <time.h>
+#include "host.h"
+
+// chord.h declares chords_count const, the benchmark sets it per run
+#define chords_count chords_count_declared
+#include "chord.h"
+#undef chords_count
+
+// chord.c through QMK's action path as keyboard.c calls it: chords
+// formed, timed out and passed by, a complete chord sent by its own term
+// while a longer one still waits, then the cost per key event against
+// the number of chords.
+
+#define BENCH_CHORDS 250
+#define BENCH_EVENTS 20000
+
+enum {
+    SHORT = 0, // J + K
+    LONG,      // J + K + L, a longer term
+    FIRST_BENCH,
+};
+
+#define J CHORD_KEY(3, 7)
+#define K CHORD_KEY(3, 8)
+#define L CHORD_KEY(3, 9)
+
+// chord i of the benchmark: position i with one 1, 32 or 63 further on
+#define BENCH_KEY(i) ((i) % CHORD_POSITIONS + 1)
+#define BENCH_PAIR(i) ((((i) % CHORD_POSITIONS) + 1 + (i) / CHORD_POSITIONS * 31) % CHORD_POSITIONS + 1)
+#define CH(i) {KC_A + (i) % 26, 0, {BENCH_KEY(i), BENCH_PAIR(i)}}
+#define CH10(i) CH((i) * 10), CH((i) * 10 + 1), CH((i) * 10 + 2), CH((i) * 10 + 3), CH((i) * 10 + 4), CH((i) * 10 + 5), CH((i) * 10 + 6), CH((i) * 10 + 7), CH((i) * 10 + 8), CH((i) * 10 + 9)
+#define CH50(i) CH10((i) * 5), CH10((i) * 5 + 1), CH10((i) * 5 + 2), CH10((i) * 5 + 3), CH10((i) * 5 + 4)
+
+const chord_t PROGMEM chords[] = {
+    [SHORT] = {KC_ESC, 20, {J, K}},
+    [LONG]  = {KC_TAB, 60, {J, K, L}},
+    CH50(0), CH50(1), CH50(2), CH50(3), CH50(4),
+};
+uint8_t chords_count;
+
+_Static_assert(ARRAY_SIZE(chords) == FIRST_BENCH + BENCH_CHORDS, "benchmark chords");
+
+// keyboard.c's hook
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return process_chord(record);
+}
+
+// every key a letter by its position
+#define KEYCODE(position) (KC_A + ((position) - 1) % 26)
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    return KEYCODE(CHORD_KEY(key.row, key.col));
+}
+
+static void key(uint8_t position, bool pressed) {
+    host_key((position - 1) / MATRIX_COLS, (position - 1) % MATRIX_COLS, pressed);
+}
+
+// ms of chord_task passes, one per ms
+static void wait(uint16_t ms) {
+    for (uint16_t i = 0; i < ms; i++) {
+        host_advance(1);
+        chord_task();
+    }
+}
+
+// the time of the first report holding keycode since the last clear, -1 for none
+static int64_t sent_at(uint8_t keycode) {
+    for (uint32_t i = 0; i < host_report_count(); i++) {
+        if (host_report(i)->kind == HOST_KEYBOARD && host_report_has_key(host_report(i), keycode)) {
+            return host_report(i)->us;
+        }
+    }
+    return -1;
+}
+
+static uint64_t clock_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// press and release of random keys 40 ms apart, ns per event in process
+static uint32_t bench(uint8_t count) {
+    uint64_t spent = 0;
+
+    chords_count = FIRST_BENCH + count;
+    chord_init();
+    srand(3);
+    for (uint32_t i = 0; i < BENCH_EVENTS / 2; i++) {
+        uint8_t  position = rand() % CHORD_POSITIONS + 1;
+        uint64_t start    = clock_ns();
+
+        key(position, true);
+        spent += clock_ns() - start;
+        wait(10);
+        start = clock_ns();
+        key(position, false);
+        spent += clock_ns() - start;
+        wait(30);
+        host_reports_clear();
+    }
+    return spent / BENCH_EVENTS;
+}
+
+int main(void) {
+    chords_count = FIRST_BENCH;
+    chord_init();
+    host_advance(100);
+
+    // within the term: the chord's keycode, the member keys swallowed
+    key(J, true);
+    wait(5);
+    key(K, true);
+    wait(70);
+    CHECK(sent_at(KC_ESC) >= 0);
+    CHECK_EQ(sent_at(KEYCODE(J)), -1);
+    key(J, false);
+    key(K, false);
+    CHECK(!host_report_has_key(host_report(host_report_count() - 1), KC_ESC));
+    host_reports_clear();
+
+    // J + K is complete while J + K + L waits: sent at J + K's term, not L's
+    uint64_t first = host_now_us();
+
+    key(J, true);
+    wait(2);
+    key(K, true);
+    wait(70);
+    CHECK(sent_at(KC_ESC) >= 0);
+    CHECK(sent_at(KC_ESC) - first <= (chords[SHORT].term + 1) * 1000);
+    key(J, false);
+    key(K, false);
+    host_reports_clear();
+
+    // all three within the long term
+    key(J, true);
+    key(K, true);
+    wait(5);
+    key(L, true);
+    CHECK(sent_at(KC_TAB) >= 0);
+    CHECK_EQ(sent_at(KC_ESC), -1);
+    key(L, false);
+    key(J, false);
+    key(K, false);
+    host_reports_clear();
+
+    // a member held past every term is replayed as itself
+    key(J, true);
+    wait(70);
+    CHECK(sent_at(KEYCODE(J)) >= 0);
+    key(J, false);
+    host_reports_clear();
+
+    // a key in no chord goes straight through
+    key(CHORD_KEY(0, 0), true);
+    CHECK(sent_at(KEYCODE(CHORD_KEY(0, 0))) >= 0);
+    key(CHORD_KEY(0, 0), false);
+    host_reports_clear();
+
+    printf("chord: ns per key event, random keys:");
+    for (uint16_t count = 0; count <= BENCH_CHORDS; count += 50) {
+        printf(" %u chords %u%s", count, bench(count), count < BENCH_CHORDS ? "," : "\n");
+    }
+    return host_done("chord");
+}
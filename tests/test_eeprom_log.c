@@ -0,0 +1,283 @@
+#include <stdlib.h>
+#include "host.h"
+#include "eeprom_driver.h"
+#include "eeprom_log.h"
+#include "matrix_idle.h"
+#include "debounce_stats.h"
+#include "dynamic_keymap.h"
+#include "via.h"
+
+// eeprom_log.c over the host flash: what is flushed reads back the same
+// after a reload, through log records and snapshots, with every program
+// a whole aligned unit; flash in another format starts from defaults.
+// A power cut at any erase or program leaves each word as it was before
+// or after the flush it hit. An image denser than a snapshot holds is
+// not saved, and qk61_via.c refuses the VIA keymap writes that would
+// make it so.
+
+// literal words a snapshot holds, EEPROM_LOG_LITERAL_MAX of eeprom_log.c
+// with its 12 byte page header
+#define LITERAL_MAX (((FEE_PAGE_COUNT - 1) / 2 * (FEE_PAGE_SIZE - 12) - (EEPROM_SIZE / 2 + 3) / 4) / 2)
+
+// flushes of the power cut sweep, enough records to roll over to a new snapshot
+#define CUT_FLUSHES 16
+#define CUT_WORDS 40
+
+static uint8_t shadow[EEPROM_SIZE];
+static uint8_t cut_images[CUT_FLUSHES + 1][EEPROM_SIZE];
+static uint8_t cut_flash[FEE_PAGE_SIZE * FEE_PAGE_COUNT];
+
+bool matrix_is_idle(void) {
+    return true;
+}
+
+void matrix_idle_wait(uint32_t ms) {}
+
+uint8_t debounce_chatter_count(uint8_t row, uint8_t col) {
+    return 0;
+}
+
+uint8_t debounce_window(uint8_t row, uint8_t col) {
+    return 0;
+}
+
+void debounce_stats_clear(void) {}
+
+static void write(uint16_t addr, const void *data, uint16_t size) {
+    eeprom_write_block(data, (void *)(uintptr_t)addr, size);
+    memcpy(&shadow[addr], data, size);
+}
+
+static bool image_matches(void) {
+    static uint8_t image[EEPROM_SIZE];
+
+    eeprom_read_block(image, 0, sizeof(image));
+    return !memcmp(image, shadow, sizeof(image));
+}
+
+// power cycle: the image rebuilt from flash alone
+static void reload(void) {
+    eeprom_driver_init();
+}
+
+static uint32_t flash_ops(void) {
+    return host_flash_stats.erases + host_flash_stats.programs;
+}
+
+// the sweep's writes, the same every run; with ops, the flash operations
+// after each flush and the image it saved
+static void cut_run(uint32_t *ops) {
+    uint32_t start = flash_ops();
+
+    srand(21);
+    for (uint8_t flush = 0; flush < CUT_FLUSHES; flush++) {
+        for (uint8_t i = 0; i < CUT_WORDS; i++) {
+            uint16_t addr  = rand() % 800 & ~1;
+            uint16_t value = rand();
+
+            write(addr, &value, 2);
+        }
+        eeprom_log_flush();
+        if (ops) {
+            ops[flush] = flash_ops() - start;
+            memcpy(cut_images[flush + 1], shadow, EEPROM_SIZE);
+        }
+    }
+}
+
+// words of the image that are neither of before nor of after
+static uint16_t words_between(const uint8_t *before, const uint8_t *after) {
+    static uint8_t image[EEPROM_SIZE];
+    uint16_t       bad = 0;
+
+    eeprom_read_block(image, 0, sizeof(image));
+    for (uint16_t i = 0; i < EEPROM_SIZE; i += 2) {
+        bad += memcmp(&image[i], &before[i], 2) && memcmp(&image[i], &after[i], 2);
+    }
+    return bad;
+}
+
+// a VIA keycode write as the app sends it, true when accepted
+static bool via_set_keycode(uint8_t layer, uint8_t row, uint8_t col, uint16_t keycode) {
+    uint8_t data[32] = {id_dynamic_keymap_set_keycode, layer, row, col, keycode >> 8, keycode};
+
+    via_command_kb(data, sizeof(data));
+    return data[0] != id_unhandled;
+}
+
+int main(void) {
+    srand(9);
+    host_flash_erase_all();
+    reload();
+    CHECK(eeprom_log_is_dirty()); // blank flash, a snapshot is due
+    eeprom_log_flush();
+    CHECK_EQ(eeprom_log_stats()->snapshots, 1);
+    CHECK(image_matches());
+
+    // single words and odd lengths at odd addresses go to the log
+    write(100, "\x12\x34", 2);
+    write(301, "abc", 3);
+    eeprom_log_flush();
+    CHECK_EQ(eeprom_log_stats()->snapshots, 1);
+    reload();
+    CHECK(image_matches());
+
+    // enough writes to fill the log pages and roll over to new snapshots,
+    // within as many literal words as a snapshot holds
+    for (uint16_t round = 0; round < 400; round++) {
+        for (uint8_t i = 0; i < 8; i++) {
+            uint16_t addr  = rand() % 800;
+            uint8_t  bytes = rand();
+
+            write(addr, &bytes, 1);
+        }
+        eeprom_log_flush();
+    }
+    CHECK(eeprom_log_stats()->snapshots > 2);
+    CHECK_EQ(eeprom_log_stats()->overflows, 0);
+    reload();
+    CHECK(image_matches());
+
+    // an unflushed write is dropped by a power cycle
+    write(500, "\x55", 1);
+    reload();
+    shadow[500] = 0;
+    eeprom_read_block(&shadow[500], (void *)500, 1);
+    CHECK(image_matches());
+
+    CHECK_EQ(host_flash_stats.errors, 0);
+    CHECK(host_flash_stats.programs > 0);
+
+    // pages of the vendor driver or an older log format: all zero, resaved on the next flush
+    memset(host_flash, 0x5A, FEE_PAGE_SIZE * FEE_PAGE_COUNT);
+    reload();
+    memset(shadow, 0, sizeof(shadow));
+    CHECK(image_matches());
+    CHECK(eeprom_log_is_dirty());
+
+    // power cut at every erase and program of a run of flushes that rolls
+    // the log over to a new snapshot
+    uint32_t ops[CUT_FLUSHES];
+    uint16_t snapshots = eeprom_log_stats()->snapshots;
+    uint32_t errors    = host_flash_stats.errors;
+    uint32_t torn_bad  = 0;
+
+    eeprom_log_flush();
+    memcpy(cut_flash, host_flash, sizeof(cut_flash));
+    memcpy(cut_images[0], shadow, EEPROM_SIZE);
+    cut_run(ops);
+    CHECK(eeprom_log_stats()->snapshots > snapshots + 1);
+    for (uint32_t cut = 1; cut <= ops[CUT_FLUSHES - 1]; cut++) {
+        uint8_t flush = 0;
+
+        while (ops[flush] < cut) {
+            flush++;
+        }
+        memcpy(host_flash, cut_flash, sizeof(cut_flash));
+        reload();
+        host_flash_power_cut(cut);
+        cut_run(NULL);
+        host_flash_power_on();
+        reload();
+        torn_bad += words_between(cut_images[flush], cut_images[flush + 1]);
+        // the next flush goes on from what the cut left
+        eeprom_log_flush();
+    }
+    CHECK_EQ(torn_bad, 0);
+    CHECK_EQ(host_flash_stats.errors, errors);
+    printf("eeprom_log: power cut at each of %u flash operations\n", ops[CUT_FLUSHES - 1]);
+
+    // capacity: eeprom_log_packs() turns false on the first literal word
+    // too many. Log records still take such writes; the next snapshot
+    // cannot, the flush is counted as an overflow and its words stay in RAM
+    static const uint8_t zero[EEPROM_SIZE];
+    uint16_t             literal;
+
+    write(0, zero, EEPROM_SIZE);
+    eeprom_log_flush();
+    for (literal = 0; eeprom_log_packs(); literal++) {
+        uint16_t value = 0x1000 + literal;
+
+        write(literal * 2, &value, 2);
+    }
+    literal--;
+    CHECK_EQ(literal, LITERAL_MAX);
+    // the word too many taken back, the image packs and is saved
+    write(literal * 2, "\0\0", 2);
+    eeprom_log_flush();
+    CHECK(!eeprom_log_is_dirty());
+
+    uint16_t overflows = eeprom_log_stats()->overflows;
+    uint16_t value     = 0x2000;
+
+    while (eeprom_log_stats()->overflows == overflows && value < 0x2000 + FEE_PAGE_COUNT * FEE_PAGE_SIZE) {
+        value++;
+        write(literal * 2, &value, 2);
+        eeprom_log_flush();
+    }
+    CHECK(value > 0x2001);
+    CHECK_EQ(eeprom_log_stats()->overflows, overflows + 1);
+    CHECK(eeprom_log_is_dirty());
+    reload();
+    value--;
+    memcpy(&shadow[literal * 2], &value, 2);
+    CHECK(image_matches());
+    // back under the capacity the snapshot goes through
+    write(literal * 2, "\0\0", 2);
+    CHECK(eeprom_log_packs());
+    eeprom_log_flush();
+    CHECK(!eeprom_log_is_dirty());
+    CHECK_EQ(eeprom_log_stats()->overflows, overflows + 1);
+    reload();
+    CHECK(image_matches());
+    printf("eeprom_log: a snapshot holds %u literal words, %u of %u layers of distinct keycodes\n", literal, literal / (MATRIX_ROWS * MATRIX_COLS), DYNAMIC_KEYMAP_LAYER_COUNT);
+
+    // VIA: every key of every layer given its own keycode, the writes
+    // past the capacity are answered id_unhandled and the key is left alone
+    uint16_t accepted = 0;
+    uint16_t refused  = 0;
+
+    write(0, zero, EEPROM_SIZE);
+    eeprom_log_flush();
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                // distinct, and never stored as a word of KC_NO, KC_TRNS or 0xFFFF
+                uint16_t keycode = 0x2000 + (layer * MATRIX_ROWS + row) * MATRIX_COLS + col;
+
+                if (via_set_keycode(layer, row, col, keycode)) {
+                    accepted++;
+                    CHECK_EQ(dynamic_keymap_get_keycode(layer, row, col), keycode);
+                } else {
+                    refused++;
+                    CHECK_EQ(dynamic_keymap_get_keycode(layer, row, col), 0);
+                }
+            }
+        }
+    }
+    CHECK_EQ(accepted, LITERAL_MAX);
+    CHECK_EQ(refused, DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS - LITERAL_MAX);
+    CHECK(eeprom_log_packs());
+    eeprom_log_flush();
+    CHECK(!eeprom_log_is_dirty());
+    reload();
+    CHECK_EQ(dynamic_keymap_get_keycode(0, 0, 0), 0x2000);
+    CHECK_EQ(dynamic_keymap_get_keycode(DYNAMIC_KEYMAP_LAYER_COUNT - 1, MATRIX_ROWS - 1, MATRIX_COLS - 1), 0);
+    printf("eeprom_log: VIA accepted %u keycodes and refused %u\n", accepted, refused);
+
+    // transparent layers, as the keymap stores KC_TRNS, cost no literal words
+    write(0, zero, EEPROM_SIZE);
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                dynamic_keymap_set_keycode(layer, row, col, KC_TRNS);
+            }
+        }
+    }
+    CHECK(eeprom_log_packs());
+    eeprom_log_flush();
+    CHECK(!eeprom_log_is_dirty());
+    reload();
+    CHECK_EQ(dynamic_keymap_get_keycode(DYNAMIC_KEYMAP_LAYER_COUNT - 1, MATRIX_ROWS - 1, MATRIX_COLS - 1), KC_TRNS);
+    return host_done("eeprom_log");
+}
@@ -0,0 +1,118 @@
+#include <stdlib.h>
+#include <time.h>
+#include "host.h"
+#include "dynamic_keymap.h"
+#include "eeprom_driver.h"
+#include "keycode_cache.h"
+
+// keymap_key_to_keycode from the cache against a direct walk of the
+// dynamic keymap, over random layer states and keymap writes, then the
+// cost of a layer walk with and without it.
+
+#define ROUNDS 2000
+#define WALKS 200000
+
+// layer_switch_get_layer then the keycode at that layer, as QMK looks a
+// key up, read from the keymap
+static uint16_t direct_walk(keypos_t key) {
+    layer_state_t layers = layer_state | default_layer_state;
+    uint8_t       layer  = 0;
+
+    for (int8_t i = 31; i >= 0; i--) {
+        if ((layers & ((layer_state_t)1 << i)) && dynamic_keymap_get_keycode(i, key.row, key.col) != KC_TRNS) {
+            layer = i;
+            break;
+        }
+    }
+    return dynamic_keymap_get_keycode(layer, key.row, key.col);
+}
+
+static uint16_t cached_walk(keypos_t key) {
+    return keymap_key_to_keycode(layer_switch_get_layer(key), key);
+}
+
+// upper layers mostly transparent, as the keymaps are
+static void random_keycode(uint8_t layer, uint8_t row, uint8_t col) {
+    uint16_t keycode = layer && rand() % 3 ? KC_TRNS : KC_A + rand() % 40;
+
+    dynamic_keymap_set_keycode(layer, row, col, keycode);
+}
+
+static uint64_t clock_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// a layer key every `every` lookups, 0 for none
+static uint32_t walk_ns(uint16_t (*walk)(keypos_t), uint32_t every) {
+    uint64_t start = clock_ns();
+    uint32_t sum   = 0;
+
+    for (uint32_t i = 0; i < WALKS; i++) {
+        keypos_t key = {.col = i % MATRIX_COLS, .row = i / MATRIX_COLS % MATRIX_ROWS};
+
+        sum += walk(key);
+        if (every && i % every == 0) {
+            layer_state ^= 2;
+        }
+    }
+    CHECK(sum != 0);
+    return (clock_ns() - start) / WALKS;
+}
+
+int main(void) {
+    srand(61);
+    eeprom_driver_init();
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                random_keycode(layer, row, col);
+            }
+        }
+    }
+    keycode_cache_init();
+
+    uint32_t mismatches = 0;
+
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        switch (rand() % 4) {
+            case 0:
+                layer_state = rand() & ((1 << DYNAMIC_KEYMAP_LAYER_COUNT) - 1);
+                break;
+            case 1:
+                default_layer_state = (layer_state_t)1 << (rand() % 2);
+                break;
+            case 2:
+                // what VIA's keymap writes do
+                random_keycode(rand() % DYNAMIC_KEYMAP_LAYER_COUNT, rand() % MATRIX_ROWS, rand() % MATRIX_COLS);
+                keycode_cache_invalidate();
+                break;
+        }
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keypos_t key = {.col = col, .row = row};
+
+                mismatches += cached_walk(key) != direct_walk(key);
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+
+    // a key released after its layer went off reads the layer it was pressed on
+    keypos_t key = {.col = 3, .row = 2};
+
+    dynamic_keymap_set_keycode(1, 2, 3, KC_F3);
+    keycode_cache_invalidate();
+    layer_state = 2;
+    default_layer_state = 1;
+    CHECK_EQ(cached_walk(key), KC_F3);
+    layer_state = 0;
+    CHECK_EQ(keymap_key_to_keycode(1, key), KC_F3);
+    CHECK_EQ(cached_walk(key), dynamic_keymap_get_keycode(0, 2, 3));
+
+    layer_state = 0x0C;
+    printf("keycode_cache: lookup ns, direct/cached: steady %u/%u, layer change per 64 %u/%u, per 8 %u/%u\n", walk_ns(direct_walk, 0), walk_ns(cached_walk, 0), walk_ns(direct_walk, 64), walk_ns(cached_walk, 64), walk_ns(direct_walk, 8), walk_ns(cached_walk, 8));
+    return host_done("keycode_cache");
+}
@@ -0,0 +1,128 @@
+#include "host.h"
+#include "mod_remap.h"
+
+// mod_remap.c through QMK's action path as keyboard.c calls it: when the
+// host sees each override, the real Alt and the Alt tap, against the
+// TAPPING_TERM a tap dance on LAlt would wait before deciding.
+
+#define ESC_ROW 0 // QK_GESC
+#define TAB_ROW 1
+#define A_ROW 2
+#define C_ROW 3
+#define LALT_ROW 4
+
+const uint16_t PROGMEM lalt_overrides[] = {
+    [KC_ESC] = KC_GRV,
+    [KC_C]   = C(KC_C),
+    [KC_TAB] = A(KC_TAB),
+};
+const uint8_t lalt_overrides_count = ARRAY_SIZE(lalt_overrides);
+
+// keyboard.c's hook
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return process_mod_remap(keycode, record);
+}
+
+// one key per row in column 0
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    static const uint16_t keycodes[] = {
+        [ESC_ROW] = QK_GESC, [TAB_ROW] = KC_TAB, [A_ROW] = KC_A, [C_ROW] = KC_C, [LALT_ROW] = KC_LALT,
+    };
+
+    return key.col == 0 && key.row < ARRAY_SIZE(keycodes) ? keycodes[key.row] : KC_NO;
+}
+
+static void key(uint8_t row, bool pressed) {
+    host_key(row, 0, pressed);
+}
+
+// ms of mod_remap_task passes, one per ms
+static void wait(uint16_t ms) {
+    for (uint16_t i = 0; i < ms; i++) {
+        host_advance(1);
+        mod_remap_task();
+    }
+}
+
+// ms from start to the first report with mods and keycode (KC_NO for
+// any or none), -1 if never sent
+static int32_t sent_after(uint64_t start, uint8_t mods, uint8_t keycode) {
+    for (uint32_t i = 0; i < host_report_count(); i++) {
+        const host_report_t *report = host_report(i);
+
+        if (report->kind == HOST_KEYBOARD && report->keyboard.mods == mods && (keycode == KC_NO || host_report_has_key(report, keycode))) {
+            return (report->us - start) / 1000;
+        }
+    }
+    return -1;
+}
+
+static bool alt_sent(void) {
+    return sent_after(0, MOD_BIT(KC_LALT), KC_NO) >= 0;
+}
+
+// LAlt down, key after gap ms, both up; ms from the key press to the replacement
+static int32_t chord(uint8_t row, uint16_t gap, uint8_t mods, uint8_t keycode) {
+    host_reports_clear();
+    key(LALT_ROW, true);
+    wait(gap);
+
+    uint64_t start = host_now_us();
+
+    key(row, true);
+    wait(20);
+    key(row, false);
+    key(LALT_ROW, false);
+    wait(20);
+    return sent_after(start, mods, keycode);
+}
+
+int main(void) {
+    host_advance(100);
+
+    // overrides go out with the key press, Alt never seen
+    int32_t ctrl_c = chord(C_ROW, 30, MOD_BIT(KC_LCTL), KC_C);
+    CHECK_EQ(ctrl_c, 0);
+    CHECK(!alt_sent());
+    int32_t grave = chord(ESC_ROW, 30, 0, KC_GRV);
+    CHECK_EQ(grave, 0);
+    CHECK(!alt_sent());
+    CHECK_EQ(sent_after(0, 0, KC_ESC), -1);
+
+    // Alt + Tab keeps the real Alt down
+    int32_t alt_tab = chord(TAB_ROW, 30, MOD_BIT(KC_LALT), KC_TAB);
+    CHECK_EQ(alt_tab, 0);
+
+    // a key without an override: the real Alt goes out ahead of it
+    int32_t alt_a = chord(A_ROW, 30, MOD_BIT(KC_LALT), KC_A);
+    CHECK_EQ(alt_a, 0);
+
+    // LAlt tapped alone goes out on its release
+    host_reports_clear();
+    key(LALT_ROW, true);
+    wait(50);
+
+    uint64_t release = host_now_us();
+
+    key(LALT_ROW, false);
+    int32_t tap = sent_after(release, MOD_BIT(KC_LALT), KC_NO);
+    CHECK_EQ(tap, 0);
+
+    // held alone for the mouse: the real Alt after MOD_REMAP_ALT_HOLD
+    host_reports_clear();
+
+    uint64_t press = host_now_us();
+
+    key(LALT_ROW, true);
+    wait(MOD_REMAP_ALT_HOLD + 10);
+    int32_t hold = sent_after(press, MOD_BIT(KC_LALT), KC_NO);
+    CHECK(hold >= MOD_REMAP_ALT_HOLD && hold <= MOD_REMAP_ALT_HOLD + 1);
+    // an override after it lifts the Alt
+    key(C_ROW, true);
+    CHECK(host_report(host_report_count() - 1)->keyboard.mods == MOD_BIT(KC_LCTL));
+    key(C_ROW, false);
+    key(LALT_ROW, false);
+
+    printf("mod_remap: ms from the key to the host: LAlt+C as Ctrl+C %d, LAlt+Esc as grave %d, Alt+Tab %d, Alt+A %d; LAlt tap %d after release; Alt for the mouse %d after the press (a tap dance waits %d)\n", ctrl_c, grave, alt_tab, alt_a, tap, hold, TAPPING_TERM);
+    return host_done("mod_remap");
+}
@@ -0,0 +1,265 @@
+#include <time.h>
+#include "host.h"
+#include "qk61.h"
+#include "lib/rdr_lib/rdr_common.h"
+#include "eeprom_driver.h"
+#include "eeprom_log.h"
+#include "dynamic_keymap.h"
+#include "via.h"
+#include "qk61_via.h"
+#include "qk61_bulk.h"
+
+// qk61_bulk.c behind a simulated raw HID transport, the host side as
+// util/qk61_hid.py drives it: packets of the keymap read with stock VIA
+// get_buffer against the bulk RLE read, a load that writes it back, a
+// raw write in whole packets, and one the EEPROM snapshot cannot hold.
+// Packets are counted both ways, as qk61_hid.py bench and load print them.
+
+#define PACKET 32
+#define PAYLOAD (PACKET - BULK_HEADER)
+#define STOCK_CHUNK 28 // get_buffer bytes per round trip
+#define KEYMAP_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2)
+#define RLE_MAX (KEYMAP_SIZE * 2)
+
+// the layers of the win keymap, its tap dances by number
+enum { _WIN, _NUM, _NAV, _FUNC };
+enum { TD_WIN_CAPS, TD_NUM_TAB, TD_NUM_OFF, TD_WIN_LOCK, TD_CASE, TD_CALC, TD_CALC_OFF };
+
+#define CTRL_Z  LCTL(KC_Z)
+#define CTRL_X  LCTL(KC_X)
+#define CTRL_C  LCTL(KC_C)
+#define CTRL_V  LCTL(KC_V)
+#define PST_VAL LALT(KC_1)
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [_WIN] = LAYOUT_tkl_ansi(
+        QK_GESC,            KC_1,     KC_2,     KC_3,    KC_4,     KC_5,     KC_6,    KC_7,    KC_8,    KC_9,    KC_0,    KC_MINS, KC_EQL,  KC_BSPC,
+        TD(TD_NUM_TAB),    KC_Q,     KC_W,     KC_E,    KC_R,     KC_T,     KC_Y,    KC_U,    KC_I,    KC_O,    KC_P,    KC_LBRC, KC_RBRC, KC_BSLS,
+        TD(TD_WIN_CAPS),   KC_A,     KC_S,     KC_D,    KC_F,     KC_G,     KC_H,    KC_J,    KC_K,    KC_L,    KC_SCLN, KC_QUOT,          KC_ENT,
+        KC_LSFT,           KC_Z,     KC_X,     KC_C,    KC_V,     KC_B,     KC_N,    KC_M,    KC_COMM, KC_DOT,  KC_SLSH,                   KC_RSFT,
+        KC_LCTL,           KC_LGUI,  KC_LALT,                              KC_SPC,                    LT(_NAV, KC_RALT), TD(TD_WIN_LOCK),  KC_RCTL, MO(_FUNC)
+    ),
+
+    [_NUM] = LAYOUT_tkl_ansi(
+        KC_ESC,            _______,  _______,  _______, _______,  _______,  _______, _______, KC_PSLS, KC_PAST, _______, _______, _______, KC_BSPC,
+        TD(TD_NUM_OFF),    _______,  _______,  KC_F2,   KC_F4,    _______,  _______, KC_P7,   KC_P8,   KC_P9,   KC_PMNS, _______, _______, _______,
+        _______,           _______,  _______,  _______, KC_ENT,   _______,  S(KC_9), KC_P4,   KC_P5,   KC_P6,   KC_PPLS, _______,          KC_PENT,
+        _______,           _______,  _______,  _______, _______,  KC_EQL,   S(KC_0), KC_P1,   KC_P2,   KC_P3,   KC_PDOT,                   _______,
+        _______,           _______,  KC_LALT,                     KC_P0,                               _______, TO(_WIN), TD(TD_CALC_OFF), _______
+    ),
+
+    [_NAV] = LAYOUT_tkl_ansi(
+        KC_GRV,            KC_F1,    KC_F2,    KC_F3,   KC_F4,    KC_F5,    KC_F6,   KC_F7,   KC_F8,   KC_F9,   KC_F10,  KC_F11,  KC_F12,  KC_DEL,
+        _______,           _______,  KC_LGUI,  KC_F2,   KC_F4,    _______,  _______, KC_HOME, KC_UP,   KC_PGUP, KC_PSCR, KC_SCRL, KC_NUM,  KC_PAUS,
+        _______,           _______,  KC_LCTL,  KC_LSFT, KC_LALT,  KC_ENT,   KC_ENT,  KC_LEFT, KC_DOWN, KC_RGHT, KC_BSPC, KC_DEL,           KC_ENT,
+        KC_CAPS,           CTRL_Z,   CTRL_X,   CTRL_C,  CTRL_V,   PST_VAL,  _______, KC_END,  KC_DOT,  KC_PGDN, _______,                   TD(TD_CASE),
+        _______,           _______,  KC_LALT,                     _______,                             KC_RALT, TO(_NUM), TD(TD_CALC),     _______
+    ),
+
+    [_FUNC] = LAYOUT_tkl_ansi(
+        KC_GRV,            KC_F1,    KC_F2,    KC_F3,   KC_F4,    KC_F5,    KC_F6,   KC_F7,   KC_F8,   KC_F9,   KC_F10,  KC_F11,  KC_F12,  KC_DEL,
+        LOGO_TOG,          MD_BLE1,  MD_BLE2,  MD_BLE3, MD_24G,   _______,  _______, _______, KC_INS,  _______, _______, RGB_SPD, RGB_SPI, U_EE_CLR,
+        LOGO_MOD,          LOGO_HUD, LOGO_HUI, _______, _______,  _______,  _______, _______, _______, _______, RGB_HUD, RGB_HUI,          QK_BAT,
+        LOGO_VAI,          RGB_VAD,  RGB_VAI,  KC_CALC, _______,  _______,  _______, RGB_RMOD,                  RGB_MOD, KC_MPRV, KC_MNXT, KC_MPLY, 
+        LOGO_VAD,          LOGO_SPD, LOGO_SPI,                    RGB_TOG,                             KC_VOLD, KC_VOLU, KC_MUTE,          _______
+    )
+};
+// clang-format on
+
+uint8_t keymap_layer_count(void) {
+    return ARRAY_SIZE(keymaps);
+}
+
+// eeprom_log.c's callers outside this test
+bool matrix_is_idle(void) {
+    return true;
+}
+
+void matrix_idle_wait(uint32_t ms) {}
+
+void boot_profile_mark(uint8_t phase) {}
+
+// replies of the device since the last request
+static uint8_t  replies[64][PACKET];
+static uint8_t  reply_count;
+static uint32_t packets; // both ways
+
+static void capture(uint8_t *data, uint8_t length) {
+    if (reply_count < ARRAY_SIZE(replies)) {
+        memcpy(replies[reply_count], data, length);
+    }
+    reply_count++;
+    packets++;
+}
+
+static void request(const uint8_t *packet) {
+    uint8_t data[PACKET];
+
+    memcpy(data, packet, PACKET);
+    reply_count = 0;
+    packets++;
+    qk61_bulk_command(data, PACKET);
+}
+
+// QMK's via.c answering id_dynamic_keymap_get_buffer, the stock path
+static void stock_request(uint16_t offset, uint8_t size) {
+    uint8_t data[PACKET] = {id_dynamic_keymap_get_buffer, offset >> 8, offset & 0xFF, size};
+
+    reply_count = 0;
+    packets++;
+    dynamic_keymap_get_buffer(offset, size, &data[4]);
+    raw_hid_send(data, PACKET);
+}
+
+static void stock_read(uint8_t *keymap) {
+    for (uint16_t offset = 0; offset < KEYMAP_SIZE; offset += STOCK_CHUNK) {
+        uint8_t size = MIN(STOCK_CHUNK, KEYMAP_SIZE - offset);
+
+        stock_request(offset, size);
+        memcpy(&keymap[offset], &replies[0][4], size);
+    }
+}
+
+static uint16_t rle_decode(const uint8_t *stream, uint16_t length, uint8_t *out) {
+    uint16_t size = 0;
+
+    for (uint16_t i = 0; i < length;) {
+        uint8_t header = stream[i++];
+
+        if (header & 0x80) {
+            for (uint8_t k = 0; k <= (header & 0x7F); k++, size += 2) {
+                memcpy(&out[size], &stream[i], 2);
+            }
+            i += 2;
+        } else {
+            memcpy(&out[size], &stream[i], (header + 1) * 2);
+            size += (header + 1) * 2;
+            i += (header + 1) * 2;
+        }
+    }
+    return size;
+}
+
+// the keymap in BULK_READ_MAX requests, the RLE stream of each appended
+// to stream; the sizes are known from id_bulk_info
+static uint16_t bulk_read(uint8_t *keymap, uint8_t *stream) {
+    uint16_t stream_length = 0;
+    uint16_t size          = 0;
+
+    for (uint16_t offset = 0; offset < KEYMAP_SIZE; offset += BULK_READ_MAX) {
+        uint16_t chunk = MIN(BULK_READ_MAX, KEYMAP_SIZE - offset);
+        uint16_t start = stream_length;
+
+        request((uint8_t[PACKET]){id_qk61_bulk, id_bulk_read, BULK_KEYMAP, offset & 0xFF, offset >> 8, chunk & 0xFF, chunk >> 8, BULK_RLE});
+        for (uint8_t i = 0; i < reply_count; i++) {
+            CHECK_EQ(replies[i][2], i);
+            CHECK_EQ(!!(replies[i][3] & BULK_LAST), i == reply_count - 1);
+            memcpy(&stream[stream_length], &replies[i][BULK_HEADER], replies[i][4]);
+            stream_length += replies[i][4];
+        }
+        size += rle_decode(&stream[start], stream_length - start, &keymap[size]);
+    }
+    CHECK_EQ(size, KEYMAP_SIZE);
+    return stream_length;
+}
+
+// begin, data packets of PAYLOAD bytes and the commit; the commit's
+// status, and the bytes written in written
+static uint8_t bulk_write(const uint8_t *payload, uint16_t length, uint16_t size, uint8_t flags, uint16_t *written) {
+    request((uint8_t[PACKET]){id_qk61_bulk, id_bulk_write_begin, BULK_KEYMAP, 0, 0, size & 0xFF, size >> 8, flags});
+    for (uint16_t offset = 0, seq = 0; offset < length; offset += PAYLOAD, seq++) {
+        uint8_t packet[PACKET] = {id_qk61_bulk, id_bulk_write_data, seq, 0, MIN(PAYLOAD, length - offset)};
+
+        memcpy(&packet[BULK_HEADER], &payload[offset], packet[4]);
+        request(packet);
+        CHECK_EQ(reply_count, 0);
+    }
+    request((uint8_t[PACKET]){id_qk61_bulk, id_bulk_commit});
+    *written = replies[0][3] | (replies[0][4] << 8);
+    return replies[0][2];
+}
+
+static bool keymap_is(const uint8_t *keymap) {
+    static uint8_t image[KEYMAP_SIZE];
+
+    dynamic_keymap_get_buffer(0, KEYMAP_SIZE, image);
+    return !memcmp(image, keymap, KEYMAP_SIZE);
+}
+
+static uint64_t clock_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int main(void) {
+    static uint8_t keymap[KEYMAP_SIZE];
+    static uint8_t read[KEYMAP_SIZE];
+    static uint8_t stream[RLE_MAX];
+    static uint8_t zero[KEYMAP_SIZE];
+    uint16_t       written;
+
+    host_flash_erase_all();
+    eeprom_driver_init();
+    host_raw_hid_hook = capture;
+    host_advance(100);
+
+    // the four layers and four transparent ones, as VIA first loads them
+    dynamic_keymap_reset();
+    eeprom_log_flush();
+    dynamic_keymap_get_buffer(0, KEYMAP_SIZE, keymap);
+
+    // the stock read, two packets per round trip
+    packets = 0;
+    stock_read(read);
+    uint32_t stock = packets;
+    CHECK(!memcmp(read, keymap, KEYMAP_SIZE));
+    CHECK_EQ(stock, 2 * ((KEYMAP_SIZE + STOCK_CHUNK - 1) / STOCK_CHUNK));
+
+    // the bulk read, one request per BULK_READ_MAX bytes
+    packets = 0;
+    memset(read, 0, sizeof(read));
+    uint16_t stream_length = bulk_read(read, stream);
+    uint32_t bulk          = packets;
+    CHECK(!memcmp(read, keymap, KEYMAP_SIZE));
+    CHECK(bulk * 4 < stock); // under a quarter of the packets
+
+    // load: the RLE stream written back over a cleared keymap
+    dynamic_keymap_set_buffer(0, KEYMAP_SIZE, zero);
+    eeprom_log_flush();
+    uint32_t flushes = eeprom_log_stats()->flushes;
+    packets          = 0;
+    CHECK_EQ(bulk_write(stream, stream_length, KEYMAP_SIZE, BULK_RLE, &written), BULK_OK);
+    uint32_t load = packets - 1; // qk61_hid.py counts no commit reply
+    CHECK_EQ(written, KEYMAP_SIZE);
+    CHECK(keymap_is(keymap));
+    CHECK_EQ(eeprom_log_stats()->flushes, flushes + 1);
+
+    // raw: every packet's payload in one write
+    dynamic_keymap_set_buffer(0, KEYMAP_SIZE, zero);
+    eeprom_log_flush();
+    packets        = 0;
+    uint64_t start = clock_ns();
+    CHECK_EQ(bulk_write(keymap, KEYMAP_SIZE, KEYMAP_SIZE, 0, &written), BULK_OK);
+    uint64_t raw_ns  = clock_ns() - start;
+    uint32_t raw     = packets - 1;
+    CHECK_EQ(written, KEYMAP_SIZE);
+    CHECK(keymap_is(keymap));
+
+    // a raw write past what a snapshot holds: stopped at a packet, rolled back
+    static uint8_t distinct[KEYMAP_SIZE];
+    for (uint16_t i = 0; i < KEYMAP_SIZE; i += 2) {
+        distinct[i]     = 0x20 + i / 256;
+        distinct[i + 1] = i / 2;
+    }
+    CHECK_EQ(bulk_write(distinct, KEYMAP_SIZE, KEYMAP_SIZE, 0, &written), BULK_NO_SPACE);
+    CHECK(written > 0 && written < KEYMAP_SIZE);
+    CHECK_EQ(written % PAYLOAD, 0);
+    CHECK(keymap_is(keymap));
+    CHECK(eeprom_log_packs());
+
+    printf("qk61_bulk: %u layers of keymap, stock VIA read %u packets (%u round trips), bulk read %u packets (%u round trips, %u RLE bytes), load %u packets, raw write %u packets in %.1f us\n", DYNAMIC_KEYMAP_LAYER_COUNT, stock, stock / 2, bulk, (KEYMAP_SIZE + BULK_READ_MAX - 1) / BULK_READ_MAX, stream_length, load, raw, raw_ns / 1000.0);
+    return host_done("qk61_bulk");
+}
@@ -0,0 +1,50 @@
+#include "host.h"
+#include "qk61_trace.h"
+
+// qk61_trace.c: the ring keeps its newest TRACE_RING_SIZE entries in
+// order however far trace_head has wrapped, and a traced dance reaches
+// its own finished handler.
+
+static uint8_t finished_count;
+
+static void finished(tap_dance_state_t *state, void *user_data) {
+    finished_count = state->count;
+}
+
+static tap_dance_action_t dances[] = {
+    ACTION_TAP_DANCE_TRACED(finished, NULL),
+};
+
+static bool ring_holds(uint32_t events) {
+    trace_clear();
+    for (uint32_t i = 0; i < events; i++) {
+        TRACE(TRACE_REPORT, i);
+    }
+
+    uint32_t kept = MIN(events, TRACE_RING_SIZE);
+
+    for (uint16_t i = 0; i < kept; i++) {
+        const trace_entry_t *entry = trace_entry(i);
+
+        if (!entry || entry->arg != (uint8_t)(events - kept + i)) {
+            return false;
+        }
+    }
+    return !trace_entry(kept);
+}
+
+int main(void) {
+    CHECK(ring_holds(0));
+    CHECK(ring_holds(3));
+    CHECK(ring_holds(TRACE_RING_SIZE + 5));
+    // trace_head wraps to a count below the ring size
+    CHECK(ring_holds(UINT16_MAX + 1 + 10));
+    CHECK(ring_holds(UINT16_MAX + 1 + TRACE_RING_SIZE * 3));
+
+    trace_clear();
+    dances[0].state.count = 2;
+    dances[0].fn.on_dance_finished(&dances[0].state, dances[0].user_data);
+    CHECK_EQ(finished_count, 2);
+    CHECK(trace_entry(0) && trace_entry(0)->event == TRACE_TAP_DANCE && trace_entry(0)->arg == 2);
+    return host_done("qk61_trace");
+}
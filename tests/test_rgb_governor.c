@@ -0,0 +1,77 @@
+#include "host.h"
+#include "rgb_governor.h"
+#include "boot_profile.h"
+
+// rgb_governor.c over the stock task model of host_drivers.c: frames per
+// effect against the stock task, and no frame held part way rendered
+// however slow the main loop is.
+
+void __real_rgb_matrix_task(void);
+
+bool boot_profile_rgb_deferred(void) {
+    return false;
+}
+
+static uint32_t held_mid_frame;
+
+// one main loop pass every pass_ms for ms, returns the frames flushed
+static uint32_t run(uint8_t mode, uint8_t speed, uint32_t pass_ms, uint32_t ms, bool governed) {
+    uint32_t frames = host_rgb_frames;
+
+    rgb_matrix_config.mode  = mode;
+    rgb_matrix_config.speed = speed;
+    for (uint32_t t = 0; t < ms; t += pass_ms) {
+        bool     rendering = host_rgb_rendering();
+        uint32_t calls     = host_rgb_calls;
+
+        if (governed) {
+            rgb_matrix_task();
+        } else {
+            __real_rgb_matrix_task();
+        }
+        held_mid_frame += rendering && host_rgb_calls == calls;
+        host_advance(pass_ms);
+    }
+    return host_rgb_frames - frames;
+}
+
+static void compare(const char *name, uint8_t mode, uint8_t speed) {
+    uint32_t stock    = run(mode, speed, 1, 10000, false);
+    uint32_t governed = run(mode, speed, 1, 10000, true);
+
+    printf("  %-18s speed %3u: frames per 10 s stock %u governed %u, LED writes saved %u%%\n", name, speed, stock, governed, 100 - governed * 100 / stock);
+}
+
+int main(void) {
+    printf("rgb_governor:\n");
+    compare("solid_color", RGB_MATRIX_CUSTOM_TABLE_SOLID_COLOR, 128);
+    compare("cycle_left_right", RGB_MATRIX_CUSTOM_TABLE_CYCLE_LEFT_RIGHT, 0);
+    compare("cycle_left_right", RGB_MATRIX_CUSTOM_TABLE_CYCLE_LEFT_RIGHT, 128);
+    compare("cycle_left_right", RGB_MATRIX_CUSTOM_TABLE_CYCLE_LEFT_RIGHT, 255);
+    compare("splash, idle", RGB_MATRIX_CUSTOM_TABLE_SPLASH, 128);
+
+    // static frames at RGB_GOVERNOR_STATIC_LIMIT, full rate while animating
+    uint32_t frames = run(RGB_MATRIX_CUSTOM_TABLE_SOLID_COLOR, 128, 1, 3300, true);
+    CHECK(frames >= 3300 / (RGB_GOVERNOR_STATIC_LIMIT + 1) - 1 && frames <= 3300 / RGB_GOVERNOR_STATIC_LIMIT + 1);
+    frames = run(RGB_MATRIX_CUSTOM_TABLE_CYCLE_LEFT_RIGHT, 255, 1, 3200, true);
+    CHECK(frames >= 3200 / (RGB_GOVERNOR_FULL_LIMIT + 1) - 1);
+    host_activity();
+    frames = run(RGB_MATRIX_CUSTOM_TABLE_SPLASH, 128, 1, 160, true);
+    CHECK(frames >= 160 / (RGB_GOVERNOR_FULL_LIMIT + 1) - 1);
+
+    // a config change, right after a frame: the next frame comes at the
+    // stock limit, not at RGB_GOVERNOR_STATIC_LIMIT
+    frames = host_rgb_frames;
+    while (host_rgb_frames == frames) {
+        run(RGB_MATRIX_CUSTOM_TABLE_SOLID_COLOR, 128, 1, 1, true);
+    }
+    rgb_matrix_config.hsv.h += 8;
+    frames = run(RGB_MATRIX_CUSTOM_TABLE_SOLID_COLOR, 128, 1, RGB_MATRIX_LED_FLUSH_LIMIT + 1, true);
+    CHECK_EQ(frames, 1);
+
+    // passes 7 ms apart: a frame takes longer than the flush limit to render
+    frames = run(RGB_MATRIX_CUSTOM_TABLE_SOLID_COLOR, 128, 7, 5000, true);
+    CHECK(frames > 0);
+    CHECK_EQ(held_mid_frame, 0);
+    return host_done("rgb_governor");
+}
@@ -0,0 +1,45 @@
+#include "host.h"
+#include "tap_learn.h"
+#include "user_config.h"
+
+// Stored terms are used only within the range tap_learn could have saved.
+
+static uint16_t loaded_term(uint8_t stored) {
+    keyrecord_t tab = {.event = {.key = {.col = 0, .row = 2}}};
+
+    memset(&user_config, 0, sizeof(user_config));
+    user_config.tap_term[0] = stored;
+    user_config_save();
+    memset(&user_config, 0xAA, sizeof(user_config));
+    user_config_init();
+    tap_learn_init();
+    return tap_learn_get_term(KC_NO, &tab);
+}
+
+int main(void) {
+    CHECK_EQ(loaded_term(0), TAPPING_TERM);
+    CHECK_EQ(loaded_term(TAP_LEARN_MIN_TERM - 1), TAPPING_TERM);
+    CHECK_EQ(loaded_term(TAP_LEARN_MIN_TERM), TAP_LEARN_MIN_TERM);
+    CHECK_EQ(loaded_term(180), 180);
+    CHECK_EQ(loaded_term(TAP_LEARN_MAX_TERM), TAP_LEARN_MAX_TERM);
+    CHECK_EQ(loaded_term(TAP_LEARN_MAX_TERM + 1), TAPPING_TERM);
+    CHECK_EQ(loaded_term(0xFF), TAPPING_TERM);
+
+    // a learned term moves from the stored one towards the taps
+    keyrecord_t tab = {.event = {.key = {.col = 0, .row = 2}}};
+
+    loaded_term(200);
+    for (uint8_t i = 0; i < 40; i++) {
+        tab.event.pressed = true;
+        tab.event.time    = timer_read();
+        tap_learn_record(TD(0), &tab);
+        host_advance(60);
+        tab.event.pressed = false;
+        tab.event.time    = timer_read();
+        tap_learn_record(TD(0), &tab);
+        host_advance(200);
+    }
+    CHECK(tap_learn_get_term(KC_NO, &tab) < 200);
+    CHECK(tap_learn_get_term(KC_NO, &tab) >= TAP_LEARN_MIN_TERM);
+    return host_done("tap_learn");
+}
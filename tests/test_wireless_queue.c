@@ -0,0 +1,148 @@
+#include "host.h"
+#include "wireless_queue.h"
+
+// wireless_queue.c in front of a loopback radio: host_drivers.c captures
+// what reaches rdr_lib's bluetooth_send_* as HOST_RADIO reports. Order,
+// merging and the queue bound, then throughput and queue time of report
+// streams faster and slower than the radio is fed.
+
+#define PASS_US 250
+
+static report_keyboard_t keys(uint8_t mods, uint8_t a, uint8_t b) {
+    return (report_keyboard_t){.mods = mods, .keys = {a, b}};
+}
+
+static void send(report_keyboard_t report) {
+    bluetooth_send_keyboard(&report);
+}
+
+// main loop passes until the queue is empty
+static void drain(void) {
+    for (uint16_t i = 0; i < 1000; i++) {
+        wireless_queue_task();
+        host_advance_us(PASS_US);
+    }
+}
+
+static const host_report_t *last(void) {
+    return host_report(host_report_count() - 1);
+}
+
+// a report every period_us for ms, returns the reports the radio got per second
+static uint32_t stream(uint32_t period_us, uint32_t ms) {
+    uint32_t start = host_report_count();
+    uint32_t next  = 0;
+
+    for (uint32_t us = 0; us < ms * 1000; us += PASS_US) {
+        for (; next <= us; next += period_us) {
+            // one key released as the next is pressed, nothing to merge
+            send(next / period_us % 2 ? keys(0, KC_B, 0) : keys(0, KC_A, 0));
+        }
+        wireless_queue_task();
+        host_advance_us(PASS_US);
+    }
+    drain();
+    return (host_report_count() - start) * 1000 / ms;
+}
+
+// the queue time under which p percent of the sent reports waited, a bucket bound
+static uint16_t wait_percentile(const wireless_queue_stats_t *stats, uint8_t p) {
+    uint32_t seen = 0;
+
+    for (uint8_t i = 0; i < WIRELESS_WAIT_BUCKETS; i++) {
+        seen += stats->wait[i];
+        if (seen * 100 >= stats->sent * p) {
+            return i ? (1 << i) - 1 : 0;
+        }
+    }
+    return UINT16_MAX;
+}
+
+static void print_stream(const char *name, uint32_t per_second) {
+    const wireless_queue_stats_t *stats = wireless_queue_stats();
+
+    printf("  %-22s %4u reports/s, queue ms mean %.2f p99 <= %u max %u, %u forced\n", name, per_second, stats->sent ? (double)stats->total_ms / stats->sent : 0.0, wait_percentile(stats, 99), stats->max_ms, stats->forced);
+}
+
+int main(void) {
+    printf("wireless_queue:\n");
+    host_advance(100);
+
+    // an idle queue passes a report on at once
+    send(keys(0, KC_A, 0));
+    CHECK_EQ(host_report_count(), 1);
+    CHECK_EQ(last()->path, HOST_RADIO);
+    CHECK(host_report_has_key(last(), KC_A));
+
+    // within the interval: a consumer report waits behind a later key report
+    bluetooth_send_consumer(0xE9);
+    send(keys(0, 0, 0));
+    CHECK_EQ(host_report_count(), 1);
+    drain();
+    CHECK_EQ(host_report_count(), 3);
+    CHECK_EQ(host_report(1)->kind, HOST_KEYBOARD);
+    CHECK_EQ(host_report(2)->kind, HOST_CONSUMER);
+
+    // a waiting press that the next report only adds to is merged, a release is not
+    host_reports_clear();
+    send(keys(0, KC_B, 0)); // idle, sent at once
+    send(keys(0, KC_B, KC_C));
+    send(keys(MOD_BIT(KC_LSFT), KC_B, KC_C));
+    send(keys(0, KC_C, 0));
+    drain();
+    CHECK_EQ(host_report_count(), 3);
+    CHECK_EQ(host_report(1)->keyboard.mods, MOD_BIT(KC_LSFT));
+    CHECK(host_report_has_key(host_report(1), KC_C));
+    CHECK(!host_report_has_key(host_report(2), KC_B));
+    CHECK_EQ(wireless_queue_stats()->merged, 1);
+
+    // full queue: the oldest goes out early, nothing is dropped
+    host_reports_clear();
+    wireless_queue_stats_clear();
+    for (uint8_t i = 0; i < WIRELESS_QUEUE_SIZE * 2; i++) {
+        send(i % 2 ? keys(0, KC_E, 0) : keys(0, KC_D, 0));
+    }
+    drain();
+    CHECK_EQ(host_report_count(), WIRELESS_QUEUE_SIZE * 2);
+    CHECK(wireless_queue_stats()->forced > 0);
+
+    // NKRO: keyboard reports go on at once, after the ones already waiting
+    host_reports_clear();
+    bluetooth_send_consumer(0xEA);
+    bluetooth_send_consumer(0);
+    keymap_config.nkro = true;
+    send(keys(0, KC_E, 0));
+    CHECK_EQ(host_report_count(), 3);
+    CHECK(host_report_has_key(last(), KC_E));
+    send(keys(0, 0, 0));
+    CHECK_EQ(host_report_count(), 4);
+    keymap_config.nkro = false;
+    drain();
+
+    // throughput and tail: paced to a report per WIRELESS_REPORT_INTERVAL
+    // until the queue is full, then the oldest goes out early
+    wireless_queue_stats_clear();
+    uint32_t typing = stream(20000, 5000);
+    print_stream("every 20 ms (typing)", typing);
+    CHECK_EQ(typing, 50);
+    CHECK_EQ(wireless_queue_stats()->max_ms, 0);
+
+    wireless_queue_stats_clear();
+    uint32_t paced = stream(WIRELESS_REPORT_INTERVAL * 1000, 5000);
+    print_stream("at the interval", paced);
+    CHECK(wireless_queue_stats()->max_ms <= 1);
+
+    wireless_queue_stats_clear();
+    uint32_t burst = stream(500, 1000);
+    const wireless_queue_stats_t *stats = wireless_queue_stats();
+    uint32_t                      waits = 0;
+    print_stream("every 0.5 ms (burst)", burst);
+    for (uint8_t i = 0; i < WIRELESS_WAIT_BUCKETS; i++) {
+        waits += stats->wait[i];
+    }
+    CHECK_EQ(waits, stats->sent);
+    CHECK(stats->forced > 0);
+    // a full queue waits at most its length in intervals
+    CHECK(stats->max_ms <= (WIRELESS_QUEUE_SIZE + 1) * WIRELESS_REPORT_INTERVAL);
+    return host_done("wireless_queue");
+}
@@ -0,0 +1,13 @@
+#include "quantum.h"
+#include "via.h"
+#include "user_config.h"
+
+user_config_t user_config;
+
+void user_config_init(void) {
+    via_read_custom_config(&user_config, 0, sizeof(user_config));
+}
+
+void user_config_save(void) {
+    via_update_custom_config(&user_config, 0, sizeof(user_config));
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+#include "quantum.h"
+#include "tap_learn.h"
+
+// Settings of our own modules, kept in the VIA custom config area. The
+// EECONFIG kb and user datablocks are rdr_lib's and are not touched.
+// eeconfig_init_user zeroes it on an EEPROM reset, all zero is every
+// default.
+typedef struct PACKED {
+    uint8_t tap_learn_flags;
+    uint8_t tap_term[TAP_LEARN_KEY_COUNT]; // learned tapping term per tap key in ms, 0 = TAPPING_TERM
+    uint8_t power_dim;                     // power_state timeouts, 0 = default
+    uint8_t power_idle;
+    uint8_t power_deep;
+} user_config_t;
+
+_Static_assert(sizeof(user_config_t) <= VIA_EEPROM_CUSTOM_CONFIG_SIZE, "VIA_EEPROM_CUSTOM_CONFIG_SIZE too small for user_config_t");
+
+extern user_config_t user_config;
+
+void user_config_init(void);
+void user_config_save(void);
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Generate led_tables.h from the g_led_config in keyboard.c.
+
+Run from the keyboard folder after changing the LED map:
+
+    python3 util/gen_led_tables.py > led_tables.h
+
+make -C tests fails while led_tables.h differs from what this prints.
+"""
+import math
+import re
+import sys
+from pathlib import Path
+
+KEYBOARD_C = Path(__file__).resolve().parent.parent / "keyboard.c"
+
+
+def led_config(source):
+    config = source[source.index("g_led_config"):]
+    # second brace group of the initializer holds the {x, y} points, the third the flags
+    points, flags = re.split(r"\},\s*\{\s*\n", config.split("},{", 1)[1], 1)
+    points = [(int(x), int(y)) for x, y in re.findall(r"\{\s*(\d+)\s*,\s*(\d+)\s*\}", points)]
+    flags = [int(f) for f in re.findall(r"\d+", flags.split("}", 1)[0])]
+    return points, flags
+
+
+# the same integer math as the splash runner, floor(sqrt(dx^2 + dy^2))
+def distance(a, b):
+    return min(math.isqrt((a[0] - b[0]) ** 2 + (a[1] - b[1]) ** 2), 255)
+
+
+# the same integer math as quantum/color.c hsv_to_rgb with s = v = 255
+def hue_rgb(h):
+    region = h * 6 // 255
+    remainder = (h * 2 - region * 85) * 3
+    v = 255
+    p = 0
+    q = (v * (255 - ((255 * remainder) >> 8))) >> 8
+    t = (v * (255 - ((255 * (255 - remainder)) >> 8))) >> 8
+    return {
+        0: (v, t, p),
+        1: (q, v, p),
+        2: (p, v, t),
+        3: (p, q, v),
+        4: (t, p, v),
+    }.get(region, (v, p, q) if region == 5 else (v, t, p))
+
+
+def table(name, ctype, rows, per_line):
+    out = [f"static const {ctype} {name} = {{"]
+    for i in range(0, len(rows), per_line):
+        out.append("    " + " ".join(f"{r}," for r in rows[i:i + per_line]))
+    out.append("};")
+    return "\n".join(out)
+
+
+def main():
+    points, flags = led_config(KEYBOARD_C.read_text())
+    # keys are the leading LEDs, only they can be hit
+    keys = max(i for i, f in enumerate(flags) if f) + 1
+    hues = ["{%3d, %3d, %3d}" % hue_rgb(h) for h in range(256)]
+
+    print("// Generated by util/gen_led_tables.py from g_led_config, do not edit.")
+    print("#pragma once")
+    print()
+    print(f"#define LED_TABLES_LED_COUNT {len(points)}")
+    print(f"#define LED_TABLES_KEY_COUNT {keys}")
+    print()
+    print("// g_led_config.point the distances are from, checked at run time")
+    print(table("led_points[LED_TABLES_LED_COUNT][2]", "uint8_t", ["{%3d, %2d}" % p for p in points], 8))
+    print()
+    print(table("led_hue_rgb[256][3]", "uint8_t", hues, 8))
+    print()
+    print("// distance from each key LED to every LED")
+    print("static const uint8_t led_distance[LED_TABLES_KEY_COUNT][LED_TABLES_LED_COUNT] = {")
+    for hit in points[:keys]:
+        row = ["%3d" % distance(hit, led) for led in points]
+        print("    {")
+        for i in range(0, len(row), 16):
+            print("        " + " ".join(f"{r}," for r in row[i:i + 16]))
+        print("    },")
+    print("};")
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,313 @@
+#!/usr/bin/env python3
+"""QK61 diagnostics and bulk keymap transfer over the VIA raw HID interface (Linux hidraw).
+
+    python3 util/qk61_hid.py trace        event trace, oldest first
+    python3 util/qk61_hid.py latency      scan-to-report latency histogram
+    python3 util/qk61_hid.py clear-trace
+    python3 util/qk61_hid.py housekeeping per job run time counters
+    python3 util/qk61_hid.py eeprom       EEPROM log flushes and page erases
+    python3 util/qk61_hid.py wireless     BLE/2.4G report queue counters
+    python3 util/qk61_hid.py boot         boot phase times and wake to report latency, this boot and the last
+    python3 util/qk61_hid.py dump keymap|macros FILE   read a region, RLE streamed
+    python3 util/qk61_hid.py load keymap|macros FILE   write a region and commit once
+    python3 util/qk61_hid.py bench        keymap read: stock VIA vs bulk, packets and time
+
+trace and latency need firmware built with QK61_TRACE_ENABLE = yes.
+Command ids match qk61_via.h.
+"""
+import glob
+import os
+import struct
+import sys
+import time
+
+VID, PID = 0x36B0, 0x3035
+PACKET = 32
+
+ID_QK61_DIAG = 0x80
+ID_UNHANDLED = 0xFF
+ID_DIAG_EEPROM_STATS = 4
+ID_DIAG_HOUSEKEEPING_STATS = 5
+ID_DIAG_TRACE_READ = 7
+ID_DIAG_LATENCY_READ = 8
+ID_DIAG_TRACE_CLEAR = 9
+ID_DIAG_WIRELESS_STATS = 10
+ID_DIAG_BOOT_READ = 12
+ID_DIAG_WAKE_STATS = 13
+
+ID_QK61_BULK = 0x81
+ID_BULK_INFO = 1
+ID_BULK_READ = 2
+ID_BULK_WRITE_BEGIN = 3
+ID_BULK_WRITE_DATA = 4
+ID_BULK_COMMIT = 5
+BULK_REGIONS = {"keymap": 0, "macros": 1}
+BULK_RLE = 1
+BULK_LAST = 1
+BULK_HEADER = 5
+BULK_STATUS = {0: "ok", 1: "lost packet", 2: "bad length", 3: "no transfer",
+               4: "no space, the keymap is too dense for the EEPROM snapshot"}
+
+ID_DYNAMIC_KEYMAP_GET_BUFFER = 0x12
+
+FEE_PAGE_COUNT = 8
+TRACE_LATENCY_BUCKETS = 16
+WIRELESS_WAIT_BUCKETS = 8
+BOOT_PHASES = ["eeprom loaded", "pre init", "post init", "vendor init", "init done",
+               "first scan", "usb ready", "first report", "rgb ready"]
+BOOT_NOT_REACHED = 0xFFFFFFFF
+EVENTS = {1: "matrix", 2: "debounce", 3: "enter", 4: "exit", 5: "tapdance", 6: "report"}
+
+
+def find_device():
+    for node in sorted(glob.glob("/sys/class/hidraw/hidraw*")):
+        try:
+            with open(os.path.join(node, "device/uevent")) as f:
+                uevent = f.read()
+            with open(os.path.join(node, "device/report_descriptor"), "rb") as f:
+                descriptor = f.read()
+        except OSError:
+            continue
+        # the VIA interface has usage page 0xFF60
+        if f"{VID:08X}:{PID:08X}" in uevent.upper() and b"\x06\x60\xff" in descriptor:
+            return "/dev/" + os.path.basename(node)
+    sys.exit("no QK61 raw HID interface found")
+
+
+class Keyboard:
+    def __init__(self):
+        self.fd = os.open(find_device(), os.O_RDWR)
+
+    def send(self, *data):
+        os.write(self.fd, b"\0" + bytes(data).ljust(PACKET, b"\0"))
+
+    def receive(self, command_id):
+        reply = os.read(self.fd, PACKET)
+        if reply[0] == ID_UNHANDLED:
+            sys.exit("command %#x not supported by this firmware" % command_id)
+        return reply
+
+    def diag(self, diag_id, *args):
+        self.send(ID_QK61_DIAG, diag_id, *args)
+        return self.receive(ID_QK61_DIAG)
+
+    def bulk(self, bulk_id, *args):
+        self.send(ID_QK61_BULK, bulk_id, *args)
+        return self.receive(ID_QK61_BULK)
+
+
+def trace(kb):
+    entries = []
+    count = None
+    while count is None or len(entries) < count:
+        reply = kb.diag(ID_DIAG_TRACE_READ, len(entries))
+        count, reload = reply[3], struct.unpack_from("<H", reply, 4)[0]
+        chunk = [struct.unpack_from("<HHBB", reply, off) for off in range(6, PACKET - 5, 6)]
+        entries += chunk[:count - len(entries)]
+    start = None
+    for ms, systick, event, arg in entries:
+        # ms is 16 bits, the clock wraps every 65.536 s
+        us = ms * 1000 + (reload - systick) * 1000 // reload
+        start = us if start is None else start
+        print("%10d us  %-9s %3d" % ((us - start) % 65536000, EVENTS.get(event, event), arg))
+
+
+def latency(kb):
+    counts = []
+    while len(counts) < TRACE_LATENCY_BUCKETS:
+        reply = kb.diag(ID_DIAG_LATENCY_READ, len(counts))
+        counts += struct.unpack_from("<14H", reply, 3)
+    for bucket, count in enumerate(counts[:TRACE_LATENCY_BUCKETS]):
+        low = (1 << (bucket - 1)) if bucket else 0
+        label = ">= %d us" % low if bucket == TRACE_LATENCY_BUCKETS - 1 else "%d-%d us" % (low, max((1 << bucket) - 1, 0))
+        print("%-16s %6d %s" % (label, count, "#" * min(count, 60)))
+
+
+def housekeeping(kb):
+    index = 0
+    while True:
+        reply = kb.diag(ID_DIAG_HOUSEKEEPING_STATS, index)
+        if index >= reply[3]:
+            break
+        runs, mean, peak, overruns, deferred, period, budget = struct.unpack_from("<IHHHHHH", reply, 4)
+        print("job %d  period %5d ms  budget %5d us  runs %8d  mean %5d us  max %5d us  overruns %5d  deferred %5d"
+              % (index, period, budget, runs, mean, peak, overruns, deferred))
+        index += 1
+
+
+def eeprom(kb):
+    reply = kb.diag(ID_DIAG_EEPROM_STATS)
+    flushes, snapshots, stall = struct.unpack_from("<HHI", reply, 2)
+    erases = struct.unpack_from("<%dH" % FEE_PAGE_COUNT, reply, 10)
+    (overflows,) = struct.unpack_from("<H", reply, 10 + 2 * FEE_PAGE_COUNT)
+    print("flushes %d  snapshots %d  stall %d ms  overflows %d" % (flushes, snapshots, stall, overflows))
+    print("page erases: " + " ".join(str(e) for e in erases))
+
+
+def wireless(kb):
+    reply = kb.diag(ID_DIAG_WIRELESS_STATS)
+    sent, total, peak, merged, forced = struct.unpack_from("<IIHHH", reply, 2)
+    mean = total / sent if sent else 0
+    print("sent %d  mean queue %.2f ms  max %d ms  merged %d  forced %d" % (sent, mean, peak, merged, forced))
+    waits = struct.unpack_from("<%dH" % WIRELESS_WAIT_BUCKETS, reply, 16)
+    for bucket, count in enumerate(waits):
+        low = (1 << (bucket - 1)) if bucket else 0
+        label = ">= %d ms" % low if bucket == WIRELESS_WAIT_BUCKETS - 1 else "%d-%d ms" % (low, max((1 << bucket) - 1, 0))
+        print("%-16s %6d %s" % (label, count, "#" * min(count, 60)))
+
+
+def boot(kb):
+    for previous, title in ((0, "this boot"), (1, "before the last reset")):
+        marks = []
+        while True:
+            reply = kb.diag(ID_DIAG_BOOT_READ, previous, len(marks))
+            resets, count = struct.unpack_from("<HB", reply, 4)
+            if len(marks) >= count:
+                break
+            room = min(count - len(marks), (PACKET - 7) // 4)
+            marks += struct.unpack_from("<%dI" % room, reply, 7)
+        if not previous:
+            print("resets since power-on %d, times in ms since the system tick started" % resets)
+        print(title)
+        for phase, us in enumerate(marks):
+            name = BOOT_PHASES[phase] if phase < len(BOOT_PHASES) else "phase %d" % phase
+            print("  %-14s %10s" % (name, "-" if us == BOOT_NOT_REACHED else "%.3f" % (us / 1000)))
+        reply = kb.diag(ID_DIAG_WAKE_STATS, previous)
+        wakes, wake_last, wake_max = struct.unpack_from("<HII", reply, 3)
+        print("  wakes %d  last wake to report %.3f ms  max %.3f ms" % (wakes, wake_last / 1000, wake_max / 1000))
+
+
+def rle_encode(data):
+    words = [data[i:i + 2] for i in range(0, len(data), 2)]
+    out = bytearray()
+    i = 0
+    while i < len(words):
+        run = 1
+        while i + run < len(words) and run < 128 and words[i + run] == words[i]:
+            run += 1
+        if run > 1:
+            out += bytes([0x80 | (run - 1)]) + words[i]
+            i += run
+            continue
+        count = 1
+        while i + count < len(words) and count < 128 and not (i + count + 1 < len(words) and words[i + count] == words[i + count + 1]):
+            count += 1
+        out += bytes([count - 1]) + b"".join(words[i:i + count])
+        i += count
+    return bytes(out)
+
+
+def rle_decode(stream):
+    out = bytearray()
+    i = 0
+    while i < len(stream):
+        header = stream[i]
+        if header & 0x80:
+            out += stream[i + 1:i + 3] * ((header & 0x7F) + 1)
+            i += 3
+        else:
+            count = header + 1
+            out += stream[i + 1:i + 1 + 2 * count]
+            i += 1 + 2 * count
+    return bytes(out)
+
+
+def bulk_info(kb):
+    reply = kb.bulk(ID_BULK_INFO)
+    read_max, keymap_size, macro_size = struct.unpack_from("<HHH", reply, 5)
+    return read_max, {"keymap": keymap_size, "macros": macro_size}
+
+
+def bulk_read(kb, region):
+    """Returns the region and the number of packets it took."""
+    read_max, sizes = bulk_info(kb)
+    data, packets = bytearray(), 2
+    for offset in range(0, sizes[region], read_max):
+        size = min(read_max, sizes[region] - offset)
+        kb.send(ID_QK61_BULK, ID_BULK_READ, BULK_REGIONS[region], *struct.pack("<HH", offset, size), BULK_RLE)
+        stream, seq = bytearray(), 0
+        while True:
+            reply = kb.receive(ID_QK61_BULK)
+            packets += 1
+            if reply[2] != seq & 0xFF:
+                sys.exit("lost a data packet")
+            stream += reply[BULK_HEADER:BULK_HEADER + reply[4]]
+            seq += 1
+            if reply[3] & BULK_LAST:
+                break
+        data += rle_decode(bytes(stream))
+        packets += 1
+    return bytes(data), packets
+
+
+def dump(kb, region, path):
+    data, packets = bulk_read(kb, region)
+    with open(path, "wb") as f:
+        f.write(data)
+    print("%s: %d bytes in %d packets" % (region, len(data), packets))
+
+
+def load(kb, region, path):
+    with open(path, "rb") as f:
+        data = f.read()
+    _, sizes = bulk_info(kb)
+    if len(data) != sizes[region]:
+        sys.exit("%s is %d bytes, the %s region is %d" % (path, len(data), region, sizes[region]))
+    stream = rle_encode(data)
+    kb.send(ID_QK61_BULK, ID_BULK_WRITE_BEGIN, BULK_REGIONS[region], *struct.pack("<HH", 0, len(data)), BULK_RLE)
+    payload = PACKET - BULK_HEADER
+    chunks = [stream[i:i + payload] for i in range(0, len(stream), payload)]
+    for seq, chunk in enumerate(chunks):
+        kb.send(ID_QK61_BULK, ID_BULK_WRITE_DATA, seq & 0xFF, 0, len(chunk), *chunk)
+    reply = kb.bulk(ID_BULK_COMMIT)
+    written = struct.unpack_from("<H", reply, 3)[0]
+    print("%s: %d bytes in %d packets, %s" % (region, written, len(chunks) + 2, BULK_STATUS.get(reply[2], reply[2])))
+    if reply[2]:
+        sys.exit(1)
+
+
+def bench(kb):
+    _, sizes = bulk_info(kb)
+    start = time.monotonic()
+    stock = bytearray()
+    for offset in range(0, sizes["keymap"], 28):
+        size = min(28, sizes["keymap"] - offset)
+        kb.send(ID_DYNAMIC_KEYMAP_GET_BUFFER, offset >> 8, offset & 0xFF, size)
+        stock += kb.receive(ID_DYNAMIC_KEYMAP_GET_BUFFER)[4:4 + size]
+    stock_time = time.monotonic() - start
+    stock_packets = 2 * ((sizes["keymap"] + 27) // 28)
+
+    start = time.monotonic()
+    data, packets = bulk_read(kb, "keymap")
+    bulk_time = time.monotonic() - start
+    if data != stock:
+        sys.exit("bulk read differs from the stock read")
+    print("keymap %d bytes" % len(data))
+    print("stock  %4d packets %8.1f ms" % (stock_packets, stock_time * 1000))
+    print("bulk   %4d packets %8.1f ms" % (packets, bulk_time * 1000))
+
+
+COMMANDS = {
+    "trace": trace,
+    "latency": latency,
+    "clear-trace": lambda kb: kb.diag(ID_DIAG_TRACE_CLEAR),
+    "housekeeping": housekeeping,
+    "eeprom": eeprom,
+    "wireless": wireless,
+    "boot": boot,
+    "dump": dump,
+    "load": load,
+    "bench": bench,
+}
+
+
+def main():
+    if len(sys.argv) < 2 or sys.argv[1] not in COMMANDS:
+        sys.exit(__doc__)
+    if sys.argv[1] in ("dump", "load") and (len(sys.argv) != 4 or sys.argv[2] not in BULK_REGIONS):
+        sys.exit(__doc__)
+    COMMANDS[sys.argv[1]](Keyboard(), *sys.argv[2:])
+
+
+if __name__ == "__main__":
+    main()
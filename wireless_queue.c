@@ -0,0 +1,140 @@
+#include "quantum.h"
+#include "wireless_queue.h"
+
+enum {
+    REPORT_KEYBOARD,
+    REPORT_CONSUMER,
+};
+
+typedef struct {
+    uint8_t  type;
+    uint16_t queued;
+    union {
+        report_keyboard_t keyboard;
+        uint16_t          usage;
+    };
+} wireless_report_t;
+
+// rdr_lib's senders, reached through --wrap in rules.mk
+void __real_bluetooth_send_keyboard(report_keyboard_t *report);
+void __real_bluetooth_send_consumer(uint16_t usage);
+
+static wireless_report_t      queue[WIRELESS_QUEUE_SIZE];
+static uint8_t                queue_count;
+static uint16_t               last_send;
+static wireless_queue_stats_t stats;
+
+static bool keys_contain(const report_keyboard_t *report, uint8_t key) {
+    return memchr(report->keys, key, KEYBOARD_REPORT_KEYS) != NULL;
+}
+
+// true when next only presses more than report, nothing is released in between
+static bool keyboard_extends(const report_keyboard_t *report, const report_keyboard_t *next) {
+    if ((report->mods & next->mods) != report->mods) {
+        return false;
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i] && !keys_contain(next, report->keys[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void send_report(uint8_t index) {
+    wireless_report_t report = queue[index];
+    uint16_t          waited = timer_elapsed(report.queued);
+
+    queue_count--;
+    memmove(&queue[index], &queue[index + 1], (queue_count - index) * sizeof(queue[0]));
+
+    if (report.type == REPORT_KEYBOARD) {
+        __real_bluetooth_send_keyboard(&report.keyboard);
+    } else {
+        __real_bluetooth_send_consumer(report.usage);
+    }
+
+    last_send = timer_read();
+    stats.sent++;
+    stats.total_ms += waited;
+    stats.max_ms = MAX(stats.max_ms, waited);
+
+    // bucket n counts waits of 2^(n-1) to 2^n - 1 ms
+    uint8_t bucket = waited ? 32 - __builtin_clz(waited) : 0;
+
+    bucket = MIN(bucket, WIRELESS_WAIT_BUCKETS - 1);
+    if (stats.wait[bucket] < UINT16_MAX) {
+        stats.wait[bucket]++;
+    }
+}
+
+static void send_next(void) {
+    for (uint8_t i = 0; i < queue_count; i++) {
+        if (queue[i].type == REPORT_KEYBOARD) {
+            send_report(i);
+            return;
+        }
+    }
+    send_report(0);
+}
+
+void wireless_queue_task(void) {
+    if (queue_count && timer_elapsed(last_send) >= WIRELESS_REPORT_INTERVAL) {
+        send_next();
+    }
+}
+
+static wireless_report_t *queue_push(uint8_t type) {
+    if (queue_count == WIRELESS_QUEUE_SIZE) {
+        send_next();
+        stats.forced++;
+    }
+
+    wireless_report_t *report = &queue[queue_count++];
+
+    report->type   = type;
+    report->queued = timer_read();
+    return report;
+}
+
+void __wrap_bluetooth_send_keyboard(report_keyboard_t *report) {
+    // an NKRO report is not the 6KRO layout merged here, it goes on as is
+    // behind the reports already waiting
+    if (keymap_config.nkro) {
+        while (queue_count) {
+            send_next();
+        }
+        __real_bluetooth_send_keyboard(report);
+        return;
+    }
+
+    // only the newest waiting keyboard report can be merged into
+    for (int8_t i = queue_count - 1; i >= 0; i--) {
+        if (queue[i].type != REPORT_KEYBOARD) {
+            continue;
+        }
+        if (keyboard_extends(&queue[i].keyboard, report)) {
+            queue[i].keyboard = *report;
+            stats.merged++;
+            wireless_queue_task();
+            return;
+        }
+        break;
+    }
+
+    queue_push(REPORT_KEYBOARD)->keyboard = *report;
+    wireless_queue_task();
+}
+
+void __wrap_bluetooth_send_consumer(uint16_t usage) {
+    queue_push(REPORT_CONSUMER)->usage = usage;
+    wireless_queue_task();
+}
+
+const wireless_queue_stats_t *wireless_queue_stats(void) {
+    return &stats;
+}
+
+void wireless_queue_stats_clear(void) {
+    memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include "quantum.h"
+
+// Paced, prioritised queue in front of the rdr_lib radio path.
+//
+// QMK hands BLE and 2.4G reports to bluetooth_send_keyboard() and
+// bluetooth_send_consumer(), which rdr_lib implements. rules.mk wraps
+// both at link time so reports land here first. At most one report is
+// passed on every WIRELESS_REPORT_INTERVAL ms. Keyboard reports go
+// before consumer reports. A waiting keyboard report that the new one
+// only adds keys or mods to is replaced in place, the host sees the
+// same presses in one report. Releases are never merged away. With
+// NKRO on (keymap_config.nkro, FORCE_NKRO in config.h) keyboard reports
+// are passed on as they come, only consumer reports are queued.
+//
+// Every sent report's queue time lands in a log2 histogram, so the tail
+// can be read next to the mean and max. Battery level and RGB sync
+// packets are built inside rdr_lib and go to the radio module without
+// passing bluetooth_send_*, so they cannot be queued from here.
+
+#ifndef WIRELESS_QUEUE_SIZE
+#    define WIRELESS_QUEUE_SIZE 8
+#endif
+// spacing the radio module is given between reports
+#ifndef WIRELESS_REPORT_INTERVAL
+#    define WIRELESS_REPORT_INTERVAL 2
+#endif
+
+#define WIRELESS_WAIT_BUCKETS 8
+
+typedef struct {
+    uint32_t sent;
+    uint32_t total_ms; // queue time summed over sent reports
+    uint16_t max_ms;
+    uint16_t merged;
+    uint16_t forced; // sent early because the queue was full
+    uint16_t wait[WIRELESS_WAIT_BUCKETS]; // per report queue time, 0, 1, 2-3 ... >= 64 ms
+} wireless_queue_stats_t;
+
+void                          wireless_queue_task(void);
+const wireless_queue_stats_t *wireless_queue_stats(void);
+void                          wireless_queue_stats_clear(void);